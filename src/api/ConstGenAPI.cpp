@@ -13,8 +13,12 @@ void initConstGenAPI(py::module &m)
 {
     py::class_<PROJECT_NAMESPACE::ConstGen>(m , "ConstGen")
         .def(py::init<>())
+        .def("setNumThread", &PROJECT_NAMESPACE::ConstGen::setNumThread, "Set number of threads for parsing.")
+        .def("readSupplyConfig", &PROJECT_NAMESPACE::ConstGen::readSupplyConfig, "Read Power/Ground net rules.")
         .def("addNet", &PROJECT_NAMESPACE::ConstGen::addNet, "Add net to netlist.")
         .def("addInst", &PROJECT_NAMESPACE::ConstGen::addInst, "Add instance to netlist.")
         .def("addInstPin", &PROJECT_NAMESPACE::ConstGen::addInstPin, "Add instance pin.")
+        .def("saveSnapshot", &PROJECT_NAMESPACE::ConstGen::saveSnapshot, "Write binary netlist snapshot.")
+        .def("loadSnapshot", &PROJECT_NAMESPACE::ConstGen::loadSnapshot, "Load binary netlist snapshot.")
         .def("dumpResult", &PROJECT_NAMESPACE::ConstGen::dumpResult, "Dump result to file.");
 }
@@ -16,7 +16,7 @@ void Bias::init()
     _netlist.fltrInstMosType(_driver, MosType::DIODE);
     if (valid())
     {
-        _netlist.fltrInstType(_bias, _netlist.inst(_driver[0]).type());
+        _netlist.fltrInstType(_bias, _netlist.instType(_driver[0]));
     }
 }
 
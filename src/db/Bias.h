@@ -36,7 +36,23 @@ public:
         init();
     }
 
+/*! @brief Constructor for an already detected Bias.
+
+    Used when results of a sub-netlist are translated.
+
+    @param netId Gate netId.
+    @param netlist Netlist class object.
+    @param bias Entire bias group.
+    @param driver Driver group.
+*/
+    explicit Bias(IndexType netId, const Netlist & netlist,
+                  std::vector<IndexType> && bias, std::vector<IndexType> && driver)
+        :_netId(netId), _netlist(netlist), _bias(std::move(bias)), _driver(std::move(driver))
+    {}
+
     // Getters
+/*! @brief Get gate netId. */
+    IndexType                       netId() const                   { return _netId; }
 /*! @brief Get entire bias group. */
     const std::vector<IndexType> &  bias() const                    { return _bias; }
 /*! @brief Get the driver group. */
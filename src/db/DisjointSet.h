@@ -0,0 +1,71 @@
+/*! @file db/DisjointSet.h
+    @brief Union-find over dense Ids.
+    @author agent
+    @date 10/16/2026
+*/
+#ifndef __DISJOINTSET_H__
+#define __DISJOINTSET_H__
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "global/type.h"
+
+PROJECT_NAMESPACE_BEGIN
+/*! @class DisjointSet
+    @brief Union-find over dense Ids.
+
+    Elements are 0 to size() - 1, each in a set of its
+    own at construction. Sets are joined by rank and
+    paths are halved on find(), so both are near O(1)
+    amortized. Ids are 32-bit, elements need not be Inst
+    or Net and may exceed IndexType.
+*/
+class DisjointSet
+{
+public:
+/*! @brief Constructor
+    @param size Number of elements.
+*/
+    explicit DisjointSet(std::uint32_t size = 0)
+        : _parent(size), _rank(size, 0)
+    {
+        for (std::uint32_t id = 0; id < size; id++)
+            _parent[id] = id;
+    }
+
+/*! @brief Return number of elements. */
+    std::uint32_t               size() const                        { return _parent.size(); }
+/*! @brief Return representative of the set of id. */
+    std::uint32_t               find(std::uint32_t id)
+    {
+        while (_parent[id] != id)
+        {
+            _parent[id] = _parent[_parent[id]]; // Path halving
+            id = _parent[id];
+        }
+        return id;
+    }
+/*! @brief Join sets of id1 and id2. @return false if already joined. */
+    bool                        unite(std::uint32_t id1, std::uint32_t id2)
+    {
+        id1 = find(id1);
+        id2 = find(id2);
+        if (id1 == id2)
+            return false;
+        if (_rank[id1] < _rank[id2])
+            std::swap(id1, id2);
+        _parent[id2] = id1;
+        if (_rank[id1] == _rank[id2])
+            _rank[id1]++;
+        return true;
+    }
+
+private:
+    std::vector<std::uint32_t>  _parent;
+    std::vector<Byte>           _rank;
+};
+
+PROJECT_NAMESPACE_END
+
+#endif
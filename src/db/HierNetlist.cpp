@@ -0,0 +1,127 @@
+/*! @file db/HierNetlist.cpp
+    @brief HierNetlist implementation.
+    @author agent
+    @date 10/16/2026
+*/
+#include "db/HierNetlist.h"
+#include <cstdio>
+
+PROJECT_NAMESPACE_BEGIN
+
+/*! @brief Deepest hierarchy expanded before reporting recursion. */
+static constexpr IndexType MAX_HIER_DEPTH = 256;
+
+IndexType HierNetlist::addSubckt(const std::string & name)
+{
+    auto it = _subcktId.find(name);
+    if (it != _subcktId.end())
+    {
+        _subcktArray[it->second] = Subckt();
+        _subcktArray[it->second].name = name;
+        return it->second;
+    }
+    _subcktId.emplace(name, _subcktArray.size());
+    _subcktArray.emplace_back();
+    _subcktArray.back().name = name;
+    return _subcktArray.size() - 1;
+}
+
+IndexType HierNetlist::subcktId(const std::string & name) const
+{
+    auto it = _subcktId.find(name);
+    return it == _subcktId.end() ? INDEX_TYPE_MAX : it->second;
+}
+
+IndexType HierNetlist::flatNetId(Netlist::Builder & builder, std::unordered_map<std::string, IndexType> & netId,
+                                 const std::string & name)
+{
+    auto it = netId.find(name);
+    if (it != netId.end())
+        return it->second;
+    IndexType id = netId.size();
+    netId.emplace(name, id);
+    builder.addNet(name, id);
+    return id;
+}
+
+bool HierNetlist::expand(Netlist & netlist, Netlist::Builder & builder, std::unordered_map<std::string, IndexType> & netId,
+                         const Subckt & subckt, const std::string & prefix,
+                         const std::unordered_map<std::string, IndexType> & portNet, IndexType depth)
+{
+    if (depth > MAX_HIER_DEPTH)
+    {
+        std::printf("Recursive subckt definition: %s \n", subckt.name.c_str());
+        return false;
+    }
+    auto resolve = [&](const std::string & name)
+    {
+        auto it = portNet.find(name);
+        if (it != portNet.end())
+            return it->second;
+        if (name == "0" || _globalSet.count(name))
+            return flatNetId(builder, netId, name);
+        return flatNetId(builder, netId, prefix + name);
+    };
+// Devices first, then subckt instances. Same order for every occurrence. 
+    for (const Device & dev : subckt.deviceArray)
+    {
+        builder.addInst(prefix + dev.name, dev.type, dev.wid, dev.len, dev.nf);
+        for (const std::string & net : dev.netArray)
+            builder.addPin(resolve(net));
+    }
+    for (const SubInst & inst : subckt.instArray)
+    {
+        auto it = _subcktId.find(inst.master);
+        if (it == _subcktId.end())
+        {
+            std::printf("Unknown subckt %s of instance %s%s \n", inst.master.c_str(), prefix.c_str(), inst.name.c_str());
+            return false;
+        }
+        IndexType masterId = it->second;
+        if (_subcktArray[masterId].portArray.size() != inst.netArray.size())
+        {
+            std::printf("Port mismatch of instance %s%s \n", prefix.c_str(), inst.name.c_str());
+            return false;
+        }
+        std::unordered_map<std::string, IndexType> childNet;
+        for (IndexType i = 0; i < inst.netArray.size(); i++)
+            childNet.emplace(_subcktArray[masterId].portArray[i], resolve(inst.netArray[i]));
+        IndexType occId = _occurrenceArray.size();
+        _occurrenceArray.push_back(Occurrence{masterId, prefix + inst.name, netlist.numInst(), netlist.numInst(), depth});
+        if (!expand(netlist, builder, netId, _subcktArray[masterId], prefix + inst.name + "/", childNet, depth + 1))
+            return false;
+        _occurrenceArray[occId].instEnd = netlist.numInst();
+    }
+    return true;
+}
+
+bool HierNetlist::flatten(Netlist & netlist)
+{
+    Netlist::Builder builder(netlist);
+    std::unordered_map<std::string, IndexType> netId;
+    std::unordered_map<std::string, IndexType> topNet;
+    _occurrenceArray.clear();
+    if (!_top.deviceArray.empty() || !_top.instArray.empty())
+        return expand(netlist, builder, netId, _top, "", topNet, 0);
+// No top level statements, use the last subckt not instantiated by others. 
+    std::vector<bool> isChild(_subcktArray.size(), false);
+    for (const Subckt & subckt : _subcktArray)
+        for (const SubInst & inst : subckt.instArray)
+        {
+            auto it = _subcktId.find(inst.master);
+            if (it != _subcktId.end())
+                isChild[it->second] = true;
+        }
+    for (IndexType i = _subcktArray.size(); i-- > 0; )
+    {
+        if (isChild[i])
+            continue;
+        for (const std::string & port : _subcktArray[i].portArray)
+            topNet.emplace(port, flatNetId(builder, netId, port));
+        return expand(netlist, builder, netId, _subcktArray[i], "", topNet, 0);
+    }
+    std::printf("No top level subckt found \n");
+    return false;
+}
+
+PROJECT_NAMESPACE_END
@@ -0,0 +1,129 @@
+/*! @file db/HierNetlist.h
+    @brief Hierarchical netlist of subckt masters.
+    @author agent
+    @date 10/16/2026
+*/
+#ifndef __HIERNETLIST_H__
+#define __HIERNETLIST_H__
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include "global/type.h"
+#include "db/Netlist.h"
+
+PROJECT_NAMESPACE_BEGIN
+/*! @class HierNetlist
+    @brief Hierarchical netlist of subckt masters.
+
+    Keeps the master/instance structure of a SPICE or
+    Spectre netlist. flatten() expands it into a flat
+    Netlist and records every subckt occurrence with the
+    contiguous range of flat Inst it expanded into. All
+    occurrences of a master expand their devices in the
+    same order, so local Inst i of an occurrence is flat
+    Inst instBegin + i.
+
+    Flat names are hierarchical paths joined by '/', like
+    X1/X23/M4. Nets declared global and net "0" are never
+    prefixed.
+*/
+class HierNetlist
+{
+public:
+/*! @struct Device
+    @brief Primitive device in a subckt.
+*/
+    struct Device
+    {
+        std::string                 name;
+        InstType                    type = InstType::OTHER;
+        std::vector<std::string>    netArray;
+        RealType                    wid = 0, len = 0, nf = 1;
+    };
+/*! @struct SubInst
+    @brief Subckt instance in a subckt.
+*/
+    struct SubInst
+    {
+        std::string                 name;
+        std::string                 master;
+        std::vector<std::string>    netArray;
+    };
+/*! @struct Subckt
+    @brief Subckt master.
+*/
+    struct Subckt
+    {
+        std::string                 name;
+        std::vector<std::string>    portArray;
+        std::vector<Device>         deviceArray;
+        std::vector<SubInst>        instArray;
+    };
+/*! @struct Occurrence
+    @brief One expanded subckt instance in the flat Netlist.
+*/
+    struct Occurrence
+    {
+        IndexType                   masterId;
+        std::string                 path; /*!< Hierarchical name, like X1/X23. */
+        IndexType                   instBegin, instEnd; /*!< Flat Inst range. */
+        IndexType                   depth;
+    };
+
+public:
+/*! @brief Default Constructor */
+    explicit HierNetlist() = default;
+
+/*! @brief Return top level statements outside any subckt. */
+    Subckt &                        top()                               { return _top; }
+/*! @brief Add subckt master and return its Id. 
+    
+    Redefinitions replace the old master.
+*/
+    IndexType                       addSubckt(const std::string & name);
+/*! @brief Declare global net. */
+    void                            addGlobal(const std::string & name) { _globalSet.insert(name); }
+
+/*! @brief Expand hierarchy into empty flat netlist.
+
+    If there are no top level statements the subckt that is
+    not instantiated by any other subckt is used as top, the
+    last defined one if there are several.
+
+    @return false if a master is missing or recursive.
+*/
+    bool                            flatten(Netlist & netlist);
+
+    // Getters
+/*! @brief Return number of subckt masters. */
+    IndexType                       numSubckt() const                   { return _subcktArray.size(); }
+/*! @brief Return Id of subckt master name, INDEX_TYPE_MAX if undefined. */
+    IndexType                       subcktId(const std::string & name) const;
+/*! @brief Return subckt master of Id. */
+    const Subckt &                  subckt(IndexType id) const          { return _subcktArray.at(id); }
+/*! @brief Return subckt master of Id. */
+    Subckt &                        subckt(IndexType id)                { return _subcktArray.at(id); }
+/*! @brief Return all occurrences in pre-order, filled by flatten(). */
+    const std::vector<Occurrence> & occurrenceArray() const             { return _occurrenceArray; }
+
+private:
+    Subckt                          _top;
+    std::vector<Subckt>             _subcktArray;
+    std::unordered_map<std::string, IndexType>  _subcktId;
+    std::unordered_set<std::string> _globalSet;
+    std::vector<Occurrence>         _occurrenceArray;
+
+/*! @brief Flat net Id by name, adds net to netlist if new. */
+    IndexType                       flatNetId(Netlist::Builder & builder, std::unordered_map<std::string, IndexType> & netId,
+                                        const std::string & name);
+/*! @brief Recursively expand subckt into netlist. */
+    bool                            expand(Netlist & netlist, Netlist::Builder & builder, std::unordered_map<std::string, IndexType> & netId,
+                                        const Subckt & subckt, const std::string & prefix,
+                                        const std::unordered_map<std::string, IndexType> & portNet, IndexType depth);
+};
+
+PROJECT_NAMESPACE_END
+
+#endif
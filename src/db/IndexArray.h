@@ -0,0 +1,61 @@
+/*! @file db/IndexArray.h
+    @brief Read-only view of contiguous Ids.
+    @author agent
+    @date 10/16/2026
+*/
+#ifndef __INDEXARRAY_H__
+#define __INDEXARRAY_H__
+
+#include <stdexcept>
+#include "global/type.h"
+
+PROJECT_NAMESPACE_BEGIN
+/*! @class IndexArray
+    @brief Read-only view of contiguous Ids.
+
+    Span-like view into storage owned elsewhere, used for
+    pin arrays kept in CSR form by Netlist. Supports the
+    same reads as const std::vector<IndexType> &, so range
+    for, size() and at() work unchanged.
+*/
+class IndexArray
+{
+public:
+    using value_type        = IndexType;
+    using const_iterator    = const IndexType *;
+    using iterator          = const_iterator;
+
+/*! @brief Default Constructor, empty view. */
+    explicit IndexArray() = default;
+/*! @brief Constructor
+    @param data First Id.
+    @param size Number of Ids.
+*/
+    explicit IndexArray(const IndexType * data, IndexType size)
+        : _data(data), _size(size)
+    {}
+
+    const_iterator      begin() const                   { return _data; }
+    const_iterator      end() const                     { return _data + _size; }
+    const IndexType *   data() const                    { return _data; }
+    IndexType           size() const                    { return _size; }
+    bool                empty() const                   { return _size == 0; }
+    IndexType           operator[](IndexType i) const   { return _data[i]; }
+    IndexType           front() const                   { return _data[0]; }
+    IndexType           back() const                    { return _data[_size - 1]; }
+/*! @brief Return Id at i with bounds check like std::vector::at. */
+    IndexType           at(IndexType i) const
+    {
+        if (i >= _size)
+            throw std::out_of_range("IndexArray::at");
+        return _data[i];
+    }
+
+private:
+    const IndexType *   _data = nullptr;
+    IndexType           _size = 0;
+};
+
+PROJECT_NAMESPACE_END
+
+#endif
@@ -0,0 +1,141 @@
+/*! @file db/MappedVector.h
+    @brief Vector that may be a read-only view into a mapping.
+    @author agent
+    @date 10/16/2026
+*/
+#ifndef __MAPPEDVECTOR_H__
+#define __MAPPEDVECTOR_H__
+
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "global/type.h"
+
+PROJECT_NAMESPACE_BEGIN
+/*! @class MappedVector
+    @brief Vector that may be a read-only view into a mapping.
+
+    Owns its elements in a std::vector, or views elements
+    in memory kept alive by a shared handle, such as a
+    mapped snapshot. Reads go through one pointer either
+    way. Elements are written through mut(), push_back()
+    and the other modifiers, which first copy a view into
+    owned storage. A table that is only read is never
+    copied.
+
+    Reads inside non-const functions still resolve to the
+    const getters, so reading does not copy a view.
+    @tparam T Trivially copyable element.
+*/
+template <typename T>
+class MappedVector
+{
+public:
+    using value_type        = T;
+    using const_iterator    = const T *;
+    using iterator          = const_iterator;
+
+/*! @brief Default Constructor, empty and owned. */
+    explicit MappedVector() = default;
+    MappedVector(const MappedVector & other)                { *this = other; }
+    MappedVector(MappedVector && other) noexcept            { *this = std::move(other); }
+    MappedVector & operator=(const MappedVector & other)
+    {
+        _vec = other._vec;
+        _keep = other._keep;
+        _data = _keep ? other._data : _vec.data();
+        _size = other._size;
+        return *this;
+    }
+    MappedVector & operator=(MappedVector && other) noexcept
+    {
+        _vec = std::move(other._vec);
+        _keep = std::move(other._keep);
+        _data = _keep ? other._data : _vec.data();
+        _size = other._size;
+        other.sync();
+        return *this;
+    }
+/*! @brief Take elements of vec. */
+    MappedVector & operator=(std::vector<T> && vec)
+    {
+        _vec = std::move(vec);
+        _keep.reset();
+        sync();
+        return *this;
+    }
+
+    // Getters
+    const_iterator          begin() const                   { return _data; }
+    const_iterator          end() const                     { return _data + _size; }
+    const T *               data() const                    { return _data; }
+    std::size_t             size() const                    { return _size; }
+    bool                    empty() const                   { return _size == 0; }
+    const T &               operator[](std::size_t i) const { return _data[i]; }
+    const T &               back() const                    { return _data[_size - 1]; }
+    const T &               at(std::size_t i) const
+    {
+        if (i >= _size)
+            throw std::out_of_range("MappedVector::at");
+        return _data[i];
+    }
+/*! @brief Return owned capacity, views hold none. */
+    std::size_t             capacity() const                { return _vec.capacity(); }
+/*! @brief Return true if elements are a view. */
+    bool                    mapped() const                  { return static_cast<bool>(_keep); }
+
+/*! @brief View size elements at data, kept alive by keep. */
+    void                    view(const T * data, std::size_t size, std::shared_ptr<const void> keep)
+    {
+        std::vector<T>().swap(_vec);
+        _keep = std::move(keep);
+        _data = data;
+        _size = size;
+    }
+
+    // Setters
+/*! @brief Return element i for writing. */
+    T &                     mut(std::size_t i)              { own(); return _vec[i]; }
+/*! @brief Return element i for writing with bounds check. */
+    T &                     mutAt(std::size_t i)            { own(); return _vec.at(i); }
+/*! @brief Return last element for writing. */
+    T &                     mutBack()                       { own(); return _vec.back(); }
+    void                    push_back(const T & value)      { own(); _vec.push_back(value); sync(); }
+    template <typename... Args>
+    void                    emplace_back(Args &&... args)   { own(); _vec.emplace_back(std::forward<Args>(args)...); sync(); }
+    void                    resize(std::size_t size)        { own(); _vec.resize(size); sync(); }
+    void                    resize(std::size_t size, const T & value) { own(); _vec.resize(size, value); sync(); }
+    void                    reserve(std::size_t size)       { own(); _vec.reserve(size); sync(); }
+/*! @brief Append elements in [first, last). */
+    template <typename Iter>
+    void                    append(Iter first, Iter last)   { own(); _vec.insert(_vec.end(), first, last); sync(); }
+/*! @brief Replace elements, source may be in the view. */
+    void                    assign(std::size_t size, const T & value) { *this = std::vector<T>(size, value); }
+    template <typename Iter>
+    void                    assign(Iter first, Iter last)   { *this = std::vector<T>(first, last); }
+    void                    clear()                         { *this = std::vector<T>(); }
+
+private:
+    std::vector<T>          _vec;
+/*! @brief Holder of viewed memory, empty if owned. */
+    std::shared_ptr<const void> _keep;
+    const T *               _data = nullptr;
+    std::size_t             _size = 0;
+
+/*! @brief Point reads at _vec. */
+    void                    sync()                          { _data = _vec.data(); _size = _vec.size(); }
+/*! @brief Copy a view into _vec. */
+    void                    own()
+    {
+        if (!_keep)
+            return;
+        _vec.assign(_data, _data + _size);
+        _keep.reset();
+        sync();
+    }
+};
+
+PROJECT_NAMESPACE_END
+
+#endif
@@ -0,0 +1,103 @@
+/*! @file db/NameStore.cpp
+    @brief NameStore implementation.
+    @author agent
+    @date 10/16/2026
+*/
+#include "db/NameStore.h"
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+
+PROJECT_NAMESPACE_BEGIN
+
+/*! @brief Initial number of hash table slots. */
+static constexpr std::uint32_t MIN_SLOT = 16;
+/*! @brief Size of first block, blocks double up to 2^BLOCK_BITS. */
+static constexpr std::size_t MIN_BLOCK = 256;
+
+NameStore::NameStore()
+{
+    add(std::string_view());
+}
+
+std::uint32_t NameStore::add(std::string_view name)
+{
+    std::size_t numChar = name.size() + 1;
+// Position must fit BLOCK_BITS, only the first name of a long block
+    if (_block.empty() || _block.back().size() + numChar > _block.back().capacity() ||
+        _block.back().size() > BLOCK_MASK)
+    {
+        if (_block.size() > (UINT32_MAX >> BLOCK_BITS))
+            throw std::length_error("NameStore::add");
+        std::size_t numBlock = _block.empty() ? MIN_BLOCK : std::min<std::size_t>(2 * std::max(_block.back().capacity(), _block.back().size()), BLOCK_MASK + 1);
+        _block.emplace_back();
+        _block.back().reserve(std::max(numChar, numBlock));
+    }
+    MappedVector<char> & block = _block.back();
+    std::uint32_t handle = _offset.size();
+    _offset.push_back(static_cast<std::uint32_t>((_block.size() - 1) << BLOCK_BITS | block.size()));
+    block.append(name.begin(), name.end());
+    block.push_back('\0');
+    if (!_table.empty())
+        index(handle);
+    return handle;
+}
+
+std::uint32_t NameStore::append(const NameStore & other)
+{
+    std::uint32_t first = size();
+    _offset.reserve(size() + other.size());
+    for (std::uint32_t handle = 0; handle < other.size(); handle++)
+        add(other.str(handle));
+    return first;
+}
+
+std::uint32_t NameStore::slot(std::string_view name) const
+{
+    std::uint32_t mask = _table.size() - 1;
+    std::uint32_t pos = std::hash<std::string_view>()(name) & mask;
+    while (_table[pos] != UINT32_MAX && str(_table[pos]) != name)
+        pos = (pos + 1) & mask; // Linear probing
+    return pos;
+}
+
+void NameStore::rehash(std::uint32_t numSlot)
+{
+    _table.assign(numSlot, UINT32_MAX);
+    for (std::uint32_t handle = 0; handle < size(); handle++)
+        _table[slot(str(handle))] = handle; // First of equal names wins
+}
+
+void NameStore::index(std::uint32_t handle)
+{
+    std::uint32_t pos = slot(str(handle));
+    if (_table[pos] == UINT32_MAX)
+        _table[pos] = handle;
+    if (4 * size() > 3 * _table.size())
+        rehash(2 * _table.size());
+}
+
+std::uint32_t NameStore::intern(std::string_view name)
+{
+    if (_table.empty())
+    {
+        std::uint32_t numSlot = MIN_SLOT;
+        while (3 * numSlot < 4 * (size() + 1))
+            numSlot *= 2;
+        rehash(numSlot);
+    }
+    std::uint32_t pos = slot(name);
+    if (_table[pos] != UINT32_MAX)
+        return _table[pos];
+    return add(name);
+}
+
+std::size_t NameStore::memory() const
+{
+    std::size_t numByte = _offset.capacity() * sizeof(std::uint32_t) + _table.capacity() * sizeof(std::uint32_t);
+    for (const MappedVector<char> & block : _block)
+        numByte += block.capacity();
+    return numByte;
+}
+
+PROJECT_NAMESPACE_END
@@ -0,0 +1,100 @@
+/*! @file db/NameStore.h
+    @brief Arena storage of names.
+    @author agent
+    @date 10/16/2026
+*/
+#ifndef __NAMESTORE_H__
+#define __NAMESTORE_H__
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include "global/type.h"
+#include "db/MappedVector.h"
+
+PROJECT_NAMESPACE_BEGIN
+
+class NetlistSnapshot;
+
+/*! @class NameStore
+    @brief Arena storage of names.
+
+    Names are appended to fixed size character blocks and
+    referred to by 32-bit handles, so Inst and Net hold a
+    handle in place of a std::string. Blocks never move,
+    so views stay valid while the NameStore lives. Each
+    name is NUL terminated, views can be printed as C
+    strings. Handle 0 is the empty name.
+
+    add() appends without looking up existing names, as
+    Net and Inst names are unique by construction. intern()
+    returns the handle of an equal name if stored. Its hash
+    index is built on first use and kept up to date after.
+*/
+class NameStore
+{
+public:
+/*! @brief Handle of the empty name. */
+    static constexpr std::uint32_t  EMPTY = 0;
+
+/*! @brief Default Constructor, holds the empty name. */
+    explicit NameStore();
+
+/*! @brief Append name. @return Handle of name. */
+    std::uint32_t                   add(std::string_view name);
+/*! @brief Append all names of other in order.
+    @return Handle of first name, name i of other has
+    returned handle + i.
+*/
+    std::uint32_t                   append(const NameStore & other);
+/*! @brief Return handle of an equal name, added if not stored. */
+    std::uint32_t                   intern(std::string_view name);
+/*! @brief Reserve handles for numName names. */
+    void                            reserve(std::uint32_t numName)      { _offset.reserve(numName); }
+
+    // Getters
+/*! @brief Return view of name with handle. */
+    std::string_view                str(std::uint32_t handle) const
+    {
+        std::uint32_t begin = _offset[handle];
+        const MappedVector<char> & block = _block[begin >> BLOCK_BITS];
+        std::uint32_t pos = begin & BLOCK_MASK;
+        std::uint32_t end = handle + 1 < _offset.size() && (_offset[handle + 1] >> BLOCK_BITS) == (begin >> BLOCK_BITS) ?
+                            _offset[handle + 1] & BLOCK_MASK : block.size();
+        return std::string_view(block.data() + pos, end - pos - 1);
+    }
+/*! @brief Return number of stored names. */
+    std::uint32_t                   size() const                        { return _offset.size(); }
+/*! @brief Return bytes held by blocks, handles and index. */
+    std::size_t                     memory() const;
+
+private:
+/*! @brief Snapshots read and write blocks and handles directly. */
+    friend class NetlistSnapshot;
+
+/*! @brief Blocks are at most 2^BLOCK_BITS, a longer name gets its own block. */
+    static constexpr std::uint32_t  BLOCK_BITS = 20;
+    static constexpr std::uint32_t  BLOCK_MASK = (1u << BLOCK_BITS) - 1;
+/*! @brief Character blocks, never filled past capacity so
+    they are not reallocated. Also holds for copies, and
+    for views which have no capacity.
+*/
+    std::vector<MappedVector<char>> _block;
+/*! @brief Block index << BLOCK_BITS | position of each name. */
+    MappedVector<std::uint32_t>     _offset;
+/*! @brief Open addressing hash table of handles, empty
+    until intern() is called. UINT32_MAX if empty slot.
+*/
+    std::vector<std::uint32_t>      _table;
+
+/*! @brief Return slot of name in _table, empty if not stored. */
+    std::uint32_t                   slot(std::string_view name) const;
+/*! @brief Resize _table to numSlot and insert all handles. */
+    void                            rehash(std::uint32_t numSlot);
+/*! @brief Insert handle into _table, which grows at load 3/4. */
+    void                            index(std::uint32_t handle);
+};
+
+PROJECT_NAMESPACE_END
+
+#endif
@@ -6,13 +6,15 @@
 #ifndef __NET_H__
 #define __NET_H__
 
-#include <string>
 #include <vector>
 #include "global/type.h"
 
 PROJECT_NAMESPACE_BEGIN
 /*! @class Net
     @brief Net class
+
+    Name handle and Id of a net. Pins are kept by Netlist
+    in CSR form, see Netlist::NetView.
 */
 class Net
 {
@@ -20,33 +22,28 @@ public:
 /*! Default constructor. */
     explicit Net() = default;
 /*! @brief Constructor of Net.
-    @param name Name of Net.
+    @param nameId Handle of name in NameStore of Netlist.
     @param id Id of Net.
 */
-    explicit Net(const std::string &name, IndexType id) 
-        : _name(name), _id(id)
+    explicit Net(std::uint32_t nameId, IndexType id) 
+        : _nameId(nameId), _id(id)
     {}    
 
     // Getters
-/*! Return name of Net. */
-    const std::string &             name() const        { return _name; }
+/*! Return handle of name. @see Netlist::netName() */
+    std::uint32_t                   nameId() const      { return _nameId; }
 /*! Return Id of Net. */
     IndexType                       id() const          { return _id; }
-/*! Return index array of connected pins. */
-    const std::vector<IndexType> &  pinIdArray() const  { return _pinIdArray; }
     
     // Setters
-/*! Connect a pin to the net. */
-    void                        addPinId(IndexType pinId)   { _pinIdArray.push_back(pinId); } 
-/*! @brief Return net type.
-    @see #NetType.
-*/
-    NetType                     netType() const; 
+/*! Set handle of name. */
+    void                        setNameId(std::uint32_t nameId) { _nameId = nameId; }
+/*! Set Id of Net. */
+    void                        setId(IndexType id)         { _id = id; }
     
 private:
-    std::string                 _name;
-    IndexType                   _id;
-    std::vector<IndexType>      _pinIdArray;
+    std::uint32_t               _nameId = 0;
+    IndexType                   _id = INDEX_TYPE_MAX;
 };
 
 PROJECT_NAMESPACE_END
@@ -6,6 +6,7 @@
 #include "db/Netlist.h"
 #include <algorithm>
 #include <iostream>
+#include <stdexcept>
 
 PROJECT_NAMESPACE_BEGIN
 
@@ -14,6 +15,15 @@ static const PinType MOS_PIN_TYPE[4] = {PinType::DRAIN, PinType::GATE, PinType::
 /*! @brief Res/Cap Pin Types */
 static const PinType RES_PIN_TYPE[3] = {PinType::THIS, PinType::THAT, PinType::OTHER};
 
+/*! @brief Throw std::length_error if Id of the last of 
+    count objects does not fit IndexType.
+*/
+static void checkIndex(std::size_t count)
+{
+    if (count > INDEX_TYPE_MAX)
+        throw std::length_error("Netlist: too many objects for IndexType");
+}
+
 bool Netlist::isMos(InstType instType) const
 {
     return instType == InstType::NMOS || instType == InstType::PMOS;  
@@ -26,95 +36,342 @@ bool Netlist::isPasvDev(InstType instType) const
 
 IndexType Netlist::addNet(const std::string name, IndexType netIdx)
 {
-    _netArray.emplace_back(name, netIdx);
+    checkIndex(_netArray.size() + 1);
+    _netArray.emplace_back(_nameStore.add(name), netIdx);
+    _connValid = false;
     return _netArray.size()-1;
 }
 
 IndexType Netlist::addInst(const std::string name, InstType type, RealType wid, RealType len, RealType nf)
 {
-    _instArray.emplace_back(name, type, _instArray.size(), wid, len, nf);
+    checkIndex(_instArray.size() + 1);
+    _instArray.emplace_back(_nameStore.add(name), _instArray.size());
+    resizeInst();
+    setInstData(_instArray.size() - 1, type, wid, len, nf);
+    _connValid = false;
     return _instArray.size()-1;
 }
 
 void Netlist::addInstPin(IndexType instIdx, IndexType netIdx, PinType pinType)
 {
-    _instArray.at(instIdx).addPinId(_pinArray.size());
-    _netArray.at(netIdx).addPinId(_pinArray.size());
+    if (instIdx >= _instArray.size() || netIdx >= _netArray.size())
+        throw std::out_of_range("Netlist::addInstPin");
+    checkIndex(_pinArray.size() + 1);
     _pinArray.emplace_back(_pinArray.size(), instIdx, netIdx, pinType);
+    addTerm(_pinArray.back());
+    _connValid = false;
+}
+
+void Netlist::resizeInst()
+{
+    _instTypeArray.resize(_instArray.size(), InstType::OTHER);
+    _widArray.resize(_instArray.size(), 0);
+    _lenArray.resize(_instArray.size(), 0);
+    _nfArray.resize(_instArray.size(), 1);
+    _termNetId.resize(_instArray.size() * NUM_TERM, INDEX_TYPE_MAX);
+    _termPinId.resize(_instArray.size() * NUM_TERM, INDEX_TYPE_MAX);
+    _mosTypeArray.resize(_instArray.size(), MosType::CAP); // No pins, source equals drain
+}
+
+void Netlist::setInstData(IndexType instId, InstType type, RealType wid, RealType len, RealType nf)
+{
+    _instTypeArray.mut(instId) = type;
+    _widArray.mut(instId) = wid;
+    _lenArray.mut(instId) = len;
+    _nfArray.mut(instId) = nf;
+}
+
+void Netlist::addTerm(const Pin & pin)
+{
+    if (pin.type() == PinType::OTHER)
+        return;
+    std::size_t slot = static_cast<std::size_t>(pin.instId()) * NUM_TERM + static_cast<IndexType>(pin.type());
+    if (_termPinId[slot] != INDEX_TYPE_MAX)
+        return; // First pin of a PinType is the terminal, as a pin scan finds
+    _termPinId.mut(slot) = pin.id();
+    _termNetId.mut(slot) = pin.netId();
+    _mosTypeArray.mut(pin.instId()) = termMosType(pin.instId());
+}
+
+/*! @brief Build CSR offsets and Ids of pins grouped by key.
+    Counting sort, pins of one key stay in pin Id order.
+*/
+template <typename KeyOf>
+static void buildCsr(IndexType numKey, const MappedVector<Pin> & pinArray, KeyOf keyOf,
+                     MappedVector<IndexType> & offsetArray, MappedVector<IndexType> & pinIdArray)
+{
+    std::vector<IndexType> offset(numKey + 1, 0), pinId(pinArray.size());
+    for (const Pin & pin : pinArray)
+        offset[keyOf(pin) + 1]++;
+    for (IndexType i = 0; i < numKey; i++)
+        offset[i + 1] += offset[i];
+    std::vector<IndexType> pos(offset.begin(), offset.end() - 1);
+    for (IndexType i = 0; i < pinArray.size(); i++)
+        pinId[pos[keyOf(pinArray[i])]++] = i;
+    offsetArray = std::move(offset);
+    pinIdArray = std::move(pinId);
+}
+
+void Netlist::buildConn()
+{
+    if (_connValid)
+        return;
+    buildCsr(_netArray.size(), _pinArray, [](const Pin & pin) { return pin.netId(); }, _netPinOffset, _netPinId);
+    buildCsr(_instArray.size(), _pinArray, [](const Pin & pin) { return pin.instId(); }, _instPinOffset, _instPinId);
+    classifyNet();
+    _connValid = true;
+}
+
+void Netlist::setSupplyConfig(const SupplyConfig & config)
+{
+    _supplyConfig = config;
+    if (_connValid)
+        classifyNet();
+}
+
+/*! Name rules first. Then with bulk inference, unnamed
+    signal nets with enough bulk pins become supplies.
+    isSignal() is a single load of the result.
+*/
+void Netlist::classifyNet()
+{
+    std::vector<NetType> netType(_netArray.size());
+    for (IndexType netId = 0; netId < _netArray.size(); netId++)
+        netType[netId] = _supplyConfig.nameType(netName(netId));
+    for (IndexType netId = 0; netId < _netArray.size() && _supplyConfig.bulkInfer() != 0; netId++)
+    {
+        if (netType[netId] != NetType::SIGNAL || _supplyConfig.hasName(netName(netId)))
+            continue;
+        IndexType numPmos = 0, numNmos = 0;
+        for (IndexType pinId : netPinIdArray(netId))
+        {
+            const Pin & pin = _pinArray[pinId];
+            if (pin.type() != PinType::BULK)
+                continue;
+            if (_instTypeArray[pin.instId()] == InstType::PMOS)
+                numPmos++;
+            else
+                numNmos++;
+        }
+        if (numPmos + numNmos >= _supplyConfig.bulkInfer())
+            netType[netId] = numPmos > numNmos ? NetType::POWER : NetType::GROUND;
+    }
+    _netTypeArray = std::move(netType);
 }
 
 void Netlist::init(InitDataObj & obj)
 {
+    Builder builder(*this);
+    std::size_t numPin = 0;
+    for (const InitInst & inInst : obj.instArray)
+        numPin += inInst.netIdArray.size();
+    builder.reserve(obj.netArray.size(), obj.instArray.size(), numPin);
 // Add all Net to Netlist 
     for (InitNet & net : obj.netArray)
-        _netArray.emplace_back(net.name, net.id); 
+        builder.addNet(net.name, net.id);
 // Add all Inst to Netlist 
     for (InitInst & inInst : obj.instArray)
     {
+        builder.addInst(inInst.name, inInst.type, inInst.wid, inInst.len, inInst.nf);
+        for (IndexType netId : inInst.netIdArray)
+            builder.addPin(netId);
+    }
+}
+
+void Netlist::Builder::reserve(std::size_t numNet, std::size_t numInst, std::size_t numPin)
+{
+    checkIndex(numNet);
+    checkIndex(numInst);
+    numPin = std::min<std::size_t>(numPin, INDEX_TYPE_MAX); // May be an estimate
+    _netlist._netArray.reserve(numNet);
+    _netlist._instArray.reserve(numInst);
+    _netlist._pinArray.reserve(numPin);
+    _netlist._termNetId.reserve(numInst * NUM_TERM);
+    _netlist._termPinId.reserve(numInst * NUM_TERM);
+    _netlist._instTypeArray.reserve(numInst);
+    _netlist._widArray.reserve(numInst);
+    _netlist._lenArray.reserve(numInst);
+    _netlist._nfArray.reserve(numInst);
+    _netlist._mosTypeArray.reserve(numInst);
+    _netlist._nameStore.reserve(_netlist._nameStore.size() + numNet + numInst);
+    _netlist._connValid = false;
+}
+
+Net & Netlist::Builder::netAt(IndexType netIdx)
+{
+    if (netIdx >= _netlist._netArray.size())
+    {
+        checkIndex(netIdx + std::size_t(1));
+        _netlist._netArray.resize(netIdx + 1); // Placeholder until its NET record
+    }
+    return _netlist._netArray.mut(netIdx);
+}
+
+void Netlist::Builder::addNet(std::string_view name, IndexType id)
+{
+    checkIndex(_numNet + std::size_t(1));
+    std::uint32_t nameId = _netlist._nameStore.add(name);
+    if (_numNet < _netlist._netArray.size())
+    {
+        Net & net = _netlist._netArray.mut(_numNet);
+        net.setNameId(nameId);
+        net.setId(id);
+    }
+    else
+        _netlist._netArray.emplace_back(nameId, id);
+    _netlist._connValid = false;
+    _numNet++;
+}
+
+IndexType Netlist::Builder::addInst(std::string_view name, InstType type, RealType wid, RealType len, RealType nf)
+{
+    checkIndex(_netlist._instArray.size() + 1);
+    IndexType instId = _netlist._instArray.size();
+    _netlist._instArray.emplace_back(_netlist._nameStore.add(name), instId);
+    _netlist.resizeInst();
+    _netlist.setInstData(instId, type, wid, len, nf);
+    _netlist._connValid = false;
+    _numInstPin = 0;
+    return instId;
+}
+
+/*! @brief PinType of the pin added in order to an inst.
+
+    Mosfet pins are D/G/S/B, pins after the fourth are 
+    ignored. Passive device pins are THIS/THAT/OTHER.
+    @return false if the pin is ignored.
+*/
+static bool orderPinType(InstType instType, IndexType order, PinType & pinType)
+{
+    pinType = PinType::OTHER;
 // If added Inst is Mosfet 
-        if (isMos(inInst.type))
+    if (instType == InstType::NMOS || instType == InstType::PMOS)
+    {
+        if (order >= 4)
+            return false;
+        pinType = MOS_PIN_TYPE[order];
+    }
+// If added Inst is Res/Cap, modified for 2/3 pin passives 
+    else if (instType == InstType::CAP || instType == InstType::RES)
+        pinType = order < 3 ? RES_PIN_TYPE[order] : PinType::OTHER;
+// Handle Std Cells in future 
+    return true;
+}
+
+void Netlist::Builder::addPin(IndexType netIdx)
+{
+    IndexType instId = _netlist._instArray.size() - 1;
+    PinType pinType;
+    if (!orderPinType(_netlist._instTypeArray[instId], _numInstPin, pinType))
+        return;
+    _numInstPin++;
+    checkIndex(_netlist._pinArray.size() + 1);
+    netAt(netIdx); // Placeholder net if not added yet 
+    _netlist._pinArray.emplace_back(_netlist._pinArray.size(), instId, netIdx, pinType); // Add Pin 
+    _netlist.addTerm(_netlist._pinArray.back());
+}
+
+void Netlist::Builder::append(std::vector<Chunk> & chunkArray, IndexType numThread)
+{
+    IndexType numChunk = chunkArray.size();
+    std::vector<std::size_t> netOff(numChunk + 1), instOff(numChunk + 1), pinOff(numChunk + 1);
+    netOff[0] = _numNet;
+    instOff[0] = _netlist._instArray.size();
+    pinOff[0] = _netlist._pinArray.size();
+    std::size_t numNet = _netlist._netArray.size();
+    for (IndexType i = 0; i < numChunk; i++)
+    {
+        netOff[i + 1] = netOff[i] + chunkArray[i]._netArray.size();
+        instOff[i + 1] = instOff[i] + chunkArray[i]._instArray.size();
+        pinOff[i + 1] = pinOff[i] + chunkArray[i]._pinNet.size();
+        numNet = std::max(numNet, chunkArray[i]._netBound);
+    }
+    numNet = std::max(numNet, netOff[numChunk]);
+    checkIndex(numNet);
+    checkIndex(instOff[numChunk]);
+    checkIndex(pinOff[numChunk]);
+    _netlist._netArray.resize(numNet); // Nets beyond netOff[numChunk] are placeholders
+    _netlist._instArray.resize(instOff[numChunk]);
+    _netlist._pinArray.resize(pinOff[numChunk]);
+    _netlist.resizeInst();
+// Names of chunk i have handles from nameOff[i] on 
+    std::vector<std::uint32_t> nameOff(numChunk);
+    for (IndexType i = 0; i < numChunk; i++)
+        nameOff[i] = _netlist._nameStore.append(chunkArray[i]._nameStore);
+#pragma omp parallel for schedule(dynamic) num_threads(numThread)
+    for (IndexType i = 0; i < numChunk; i++)
+    {
+        Chunk & chunk = chunkArray[i];
+        for (IndexType j = 0; j < chunk._netArray.size(); j++)
         {
-            Inst inst(inInst.name, inInst.type, _instArray.size(), inInst.wid, inInst.len, inInst.nf);
-            for (IndexType i = 0; i < 4; i++)
-            {
-                inst.addPinId(_pinArray.size()); // Add pin to Inst 
-                _netArray[inInst.netIdArray.at(i)].addPinId(_pinArray.size()); // Add pin to Net 
-                _pinArray.emplace_back(_pinArray.size(), inst.id(),
-                                        inInst.netIdArray.at(i), MOS_PIN_TYPE[i]); // Add Pin    
-            }
-            _instArray.push_back(inst);
+            Net & net = _netlist._netArray.mut(netOff[i] + j);
+            net.setNameId(nameOff[i] + chunk._netArray[j].nameId);
+            net.setId(chunk._netArray[j].id);
         }
-// If added Inst is Res/Cap 
-        else if (isPasvDev(inInst.type))
+        for (IndexType j = 0; j < chunk._instArray.size(); j++)
         {
-            Inst inst(inInst.name, inInst.type, _instArray.size(), inInst.wid, inInst.len, inInst.nf);
-            for (IndexType i = 0; i < inInst.netIdArray.size(); i++) //Modified for 2/3 pin passives
+            Chunk::ChunkInst & rec = chunk._instArray[j];
+            IndexType instId = instOff[i] + j;
+            IndexType pinEnd = j + 1u < chunk._instArray.size() ? chunk._instArray[j + 1].pinBegin : chunk._pinNet.size();
+            _netlist._instArray.mut(instId) = Inst(nameOff[i] + rec.nameId, instId);
+            _netlist.setInstData(instId, rec.type, rec.wid, rec.len, rec.nf);
+            for (IndexType k = rec.pinBegin; k < pinEnd; k++)
             {
-                inst.addPinId(_pinArray.size());
-                _netArray[inInst.netIdArray.at(i)].addPinId(_pinArray.size());
-                _pinArray.emplace_back(_pinArray.size(), inst.id(), 
-                                        inInst.netIdArray.at(i), RES_PIN_TYPE[i]);
+                IndexType pinId = pinOff[i] + k;
+                _netlist._pinArray.mut(pinId) = Pin(pinId, instId, chunk._pinNet[k], chunk._pinType[k]);
+                _netlist.addTerm(_netlist._pinArray[pinId]);
             }
-            _instArray.push_back(inst);
         }
-// Handle Std Cells in future 
-        else
-        {
-            Inst inst(inInst.name, inInst.type, _instArray.size());
-            for (IndexType netId : inInst.netIdArray)
-            {
-                inst.addPinId(_pinArray.size());
-                _netArray[netId].addPinId(_pinArray.size());
-                _pinArray.emplace_back(_pinArray.size(), inst.id(), 
-                                        netId, PinType::OTHER);                
-            }    
-            _instArray.push_back(inst);
-        } 
+        chunk = Chunk();
     }
+    _netlist._connValid = false;
+    _numNet = netOff[numChunk];
+}
+
+void Netlist::Chunk::addNet(std::string_view name, IndexType id)
+{
+    _netArray.push_back(ChunkNet{_nameStore.add(name), id});
+}
+
+IndexType Netlist::Chunk::addInst(std::string_view name, InstType type, RealType wid, RealType len, RealType nf)
+{
+    _instArray.push_back(ChunkInst{_nameStore.add(name), type, wid, len, nf, static_cast<IndexType>(_pinNet.size())});
+    return _instArray.size() - 1;
+}
+
+void Netlist::Chunk::addPin(IndexType netIdx)
+{
+    ChunkInst & inst = _instArray.back();
+    PinType pinType;
+    if (!orderPinType(inst.type, _pinNet.size() - inst.pinBegin, pinType))
+        return;
+    _pinNet.push_back(netIdx);
+    _pinType.push_back(pinType);
+    _netBound = std::max<std::size_t>(_netBound, netIdx + 1);
 }
 
 void Netlist::print_all() const
 {
-// Print Net 
+// Print Net, names are NUL terminated in NameStore 
     for (const Net & net : _netArray)
     {
-        std::printf("Net %d, %s \n", net.id(), net.name().c_str());
+        std::printf("Net %d, %s \n", net.id(), _nameStore.str(net.nameId()).data());
     }
 // Print Inst 
     for (const Inst & inst : _instArray)
     {
-        std::printf("Instance %d, %s \n", inst.id(), inst.name().c_str()); 
-        for (IndexType pinId : inst.pinIdArray())
+        std::printf("Instance %d, %s \n", inst.id(), _nameStore.str(inst.nameId()).data()); 
+        for (IndexType pinId : instPinIdArray(inst.id()))
             std::printf("Pin %d, from  Instance %s to net %d:%s \n",
-                pinId, _instArray[_pinArray[pinId].instId()].name().c_str(),
-                _pinArray[pinId].netId(), _netArray[_pinArray[pinId].netId()].name().c_str()); 
+                pinId, instName(_pinArray[pinId].instId()).data(),
+                _pinArray[pinId].netId(), netName(_pinArray[pinId].netId()).data()); 
     }   
 }
 
 void Netlist::getInstNetConn(std::vector<IndexType> & instArray, IndexType netId) const
 {
     instArray.clear(); // Reset 
-    for(IndexType tempPinId : _netArray[netId].pinIdArray())
+    for(IndexType tempPinId : netPinIdArray(netId))
     {
         IndexType instId = _pinArray[tempPinId].instId();
         if(std::find(instArray.begin(), instArray.end(), instId) == instArray.end())
@@ -233,7 +490,7 @@ void Netlist::fltrInstType(std::vector<IndexType> & instArray, InstType type) co
     while (it != instArray.end() - numRmv)
     {
         IndexType instId = *it;
-        if (_instArray[instId].type() != type)
+        if (_instTypeArray[instId] != type)
         {         
             std::iter_swap(it, instArray.end() - 1 - numRmv);
             numRmv++;
@@ -246,7 +503,7 @@ void Netlist::fltrInstType(std::vector<IndexType> & instArray, InstType type) co
 
 PinType Netlist::getPinTypeInstNetConn(IndexType instId, IndexType netId) const
 {
-    for (IndexType instPinId : _instArray[instId].pinIdArray())
+    for (IndexType instPinId : instPinIdArray(instId))
         if (_pinArray[instPinId].netId() == netId)
             return _pinArray[instPinId].type();
     return PinType::OTHER; // Caution 
@@ -257,29 +514,33 @@ PinType Netlist::getPinTypeInstPinConn(IndexType instId, IndexType pinId) const
     return getPinTypeInstNetConn(instId, _pinArray[pinId].netId());
 }
 
-IndexType Netlist::instNetId(IndexType instId, PinType type) const
+IndexType Netlist::scanNetId(IndexType instId, PinType type) const
 {
-    for (IndexType pinId : _instArray[instId].pinIdArray())
+    for (IndexType pinId : instPinIdArray(instId))
         if (_pinArray[pinId].type() == type)
             return _pinArray[pinId].netId();
     return INDEX_TYPE_MAX; // Caution 
 }    
 
-MosType Netlist::mosType(IndexType mosId) const
+MosType Netlist::termMosType(IndexType mosId) const
 {
+    const IndexType * term = &_termNetId[mosId * NUM_TERM];
+    IndexType src = term[static_cast<IndexType>(PinType::SOURCE)];
+    IndexType drain = term[static_cast<IndexType>(PinType::DRAIN)];
+    IndexType gate = term[static_cast<IndexType>(PinType::GATE)];
 // Note the dominance order. 
-    if (instNetId(mosId, PinType::SOURCE) == instNetId(mosId, PinType::DRAIN))
+    if (src == drain)
         return MosType::CAP;
-    else if (instNetId(mosId, PinType::GATE) == instNetId(mosId, PinType::DRAIN))
+    else if (gate == drain)
         return MosType::DIODE;
-    else if (instNetId(mosId, PinType::GATE) == instNetId(mosId, PinType::SOURCE))
+    else if (gate == src)
         return MosType::DUMMY;
     return MosType::DIFF;
 }
 
-IndexType Netlist::instPinId(IndexType instId, PinType pinType) const
+IndexType Netlist::scanPinId(IndexType instId, PinType pinType) const
 {
-    for (IndexType pinId : _instArray[instId].pinIdArray())
+    for (IndexType pinId : instPinIdArray(instId))
         if (_pinArray[pinId].type() == pinType)
             return pinId;
     return INDEX_TYPE_MAX; // Caution 
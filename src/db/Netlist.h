@@ -8,12 +8,20 @@
 
 #include <vector>
 #include <string>
+#include <string_view>
 #include "global/type.h"
 #include "db/Net.h"
 #include "db/Pin.h"
 #include "db/Inst.h"
+#include "db/IndexArray.h"
+#include "db/MappedVector.h"
+#include "db/NameStore.h"
+#include "db/SupplyConfig.h"
 
 PROJECT_NAMESPACE_BEGIN
+
+class NetlistSnapshot;
+
 /*! @class Netlist
     @brief Netlist class
 */
@@ -47,12 +55,124 @@ public:
         std::vector<InitNet>        netArray;
         std::vector<InitInst>       instArray;
     };
+    class Builder;
+    class NetView;
+    class InstView;
+/*! @class Chunk
+    @brief Records parsed apart from the Netlist.
+
+    Same record interface as Builder, so one parser can
+    fill either. Used to parse parts of an input file in
+    parallel. Inst and pin positions are local to the 
+    Chunk until Builder::append() places it. Names are
+    stored in a NameStore of the Chunk.
+*/
+    class Chunk
+    {
+    public:
+        explicit Chunk() = default;
+
+/*! @brief Add next net. @see Builder::addNet */
+        void                        addNet(std::string_view name, IndexType id);
+/*! @brief Add next inst. @return Index of inst in Chunk. */
+        IndexType                   addInst(std::string_view name, InstType type, RealType wid, RealType len, RealType nf);
+/*! @brief Add next pin to the last added inst. @see Builder::addPin */
+        void                        addPin(IndexType netIdx);
+
+    private:
+        friend class Builder;
+        struct ChunkNet
+        {
+            std::uint32_t           nameId; /*!< Handle in _nameStore. */
+            IndexType               id;
+        };
+        struct ChunkInst
+        {
+            std::uint32_t           nameId; /*!< Handle in _nameStore. */
+            InstType                type;
+            RealType                wid, len, nf;
+            IndexType               pinBegin; /*!< First pin in _pinNet. */
+        };
+        NameStore                   _nameStore;
+        std::vector<ChunkNet>       _netArray;
+        std::vector<ChunkInst>      _instArray;
+        std::vector<IndexType>      _pinNet;
+        std::vector<PinType>        _pinType;
+/*! @brief One past largest net index referenced by a pin. */
+        std::size_t                 _netBound = 0;
+    };
+/*! @class Builder
+    @brief Streaming construction of Netlist.
+
+    Parsers drive the Builder directly as records are read,
+    so no InitDataObj intermediate is needed. Names are
+    copied into NameStore of the Netlist. Net Id is the order of addNet calls, 
+    same as init(InitDataObj &). Pins may reference nets that
+    are not added yet, those nets are created as placeholders
+    and filled in by a later addNet. Connectivity is built by
+    buildConn() when the Builder is destroyed.
+*/
+    class Builder
+    {
+    public:
+        explicit Builder(Netlist & netlist) : _netlist(netlist) {}
+        ~Builder()                                                      { _netlist.buildConn(); }
+        Builder(const Builder &) = delete;
+        Builder & operator=(const Builder &) = delete;
+
+/*! @brief Reserve capacity when counts are known or estimated.
+    Throws std::length_error if numNet or numInst do not fit IndexType.
+*/
+        void                        reserve(std::size_t numNet, std::size_t numInst, std::size_t numPin);
+/*! @brief Add next net.
+    @param name Name of net, copied into Netlist.
+    @param id Id of net as in input file.
+*/
+        void                        addNet(std::string_view name, IndexType id);
+/*! @brief Add next inst. Pins are added to it by addPin. 
+    @return Index of added inst.
+*/
+        IndexType                   addInst(std::string_view name, InstType type, RealType wid, RealType len, RealType nf);
+/*! @brief Add next pin to the last added inst.
+
+    PinType is assigned by pin order as in init(InitDataObj &).
+    Mosfet pins are D/G/S/B, pins after the fourth are ignored.
+    Passive device pins are THIS/THAT/OTHER.
+
+    @param netIdx Index of net connected to pin.
+*/
+        void                        addPin(IndexType netIdx);
+/*! @brief Add records of chunks in order.
+
+    Result is the same as replaying every record of the
+    chunks in order through addNet, addInst and addPin.
+    Net, Inst and Pin offsets of each chunk are a prefix 
+    sum over the chunks before it, so chunks are placed
+    in parallel. Chunks are left empty.
+
+    @param chunkArray Chunks in input order.
+    @param numThread Number of threads.
+*/
+        void                        append(std::vector<Chunk> & chunkArray, IndexType numThread);
+
+    private:
+        Netlist &                   _netlist;
+        IndexType                   _numNet = 0;
+/*! @brief Number of pins added to the last inst. */
+        IndexType                   _numInstPin = 0;
+/*! @brief Net index for net and creates placeholders. */
+        Net &                       netAt(IndexType netIdx);
+    };
 
 public:
 /*! @brief Default Constructor */
     explicit Netlist() = default;
     
-/*! @brief Initialize Netlist class. */
+/*! @brief Initialize Netlist class. 
+    
+    Names are copied, obj is left unchanged.
+    @see Builder
+*/
     void                            init(InitDataObj &obj);
 
 /*! @brief Add a net to netlist. */
@@ -61,6 +181,22 @@ public:
 /*! @brief Add a instance to netlist. */
     IndexType                       addInst(const std::string name, InstType type, RealType wid, RealType len, RealType nf);
 
+/*! @brief Build connectivity after pins are added.
+
+    Net and Inst pin arrays are stored as CSR: per net and
+    per inst offsets into one contiguous pin Id array. Both
+    are built from the Pin array by counting sort, so pins
+    keep the order they were added in. netPinIdArray()
+    and instPinIdArray() are views into these arrays.
+
+    Net types are classified here as well, see SupplyConfig.
+    Called by Builder on destruction and by SymDetect.
+    Does nothing if no pin, net or inst was added since
+    last call. Must be called after addInstPin and the 
+    other setters before pin arrays are read.
+*/
+    void                            buildConn();
+
 /*! @brief Add a pin to inst 
     @param Index of inst in _instArray
     @param Index of net connected to pin.
@@ -81,10 +217,56 @@ public:
     bool                            isPasvDev(InstType instType) const;
 
 /*! @brief Return true if corresponding net NetType::Signal. */
-    bool                            isSignal(IndexType netId) const     { return _netArray[netId].netType() == NetType::SIGNAL; }
-
-/*! @brief Return MosType of corresponding instance id. */
-    MosType                         mosType(IndexType mosId) const;
+    bool                            isSignal(IndexType netId) const     { return _netTypeArray[netId] == NetType::SIGNAL; }
+/*! @brief Return NetType of net, classified by SupplyConfig. */
+    NetType                         netType(IndexType netId) const      { return _netTypeArray[netId]; }
+/*! @brief Set rules for Power/Ground nets. 
+
+    Net types are classified once by buildConn(), or right
+    away if connectivity is already built. Default rules
+    are the conventional VDD/VSS names.
+*/
+    void                            setSupplyConfig(const SupplyConfig & config);
+/*! @brief Return rules for Power/Ground nets. */
+    const SupplyConfig &            supplyConfig() const                { return _supplyConfig; }
+/*! @brief Override NetType of a classified net. */
+    void                            setNetType(IndexType netId, NetType type) { _netTypeArray.mutAt(netId) = type; }
+
+/*! @brief Return MosType of corresponding instance id. 
+    Cached per inst, updated as pins are added.
+*/
+    MosType                         mosType(IndexType mosId) const      { return _mosTypeArray[mosId]; }
+/*! @brief Return InstType of Inst. @see #InstType */
+    InstType                        instType(IndexType instId) const    { return _instTypeArray[instId]; }
+/*! @brief Return width of Inst. */
+    RealType                        instWid(IndexType instId) const     { return _widArray[instId]; }
+/*! @brief Return length of Inst. */
+    RealType                        instLen(IndexType instId) const     { return _lenArray[instId]; }
+/*! @brief Return number fingers of Inst. */
+    RealType                        instNf(IndexType instId) const      { return _nfArray[instId]; }
+/*! @struct DeviceView
+    @brief Raw device arrays, for batch scans over many Insts.
+
+    Net of PinType t of inst i is termNetId[i * numTerm + t],
+    see instNetId. Pointers are invalid once Insts are added.
+*/
+    struct DeviceView
+    {
+        const IndexType *           termNetId;
+        IndexType                   numTerm;
+        const InstType *            instType;
+        const MosType *             mosType;
+        const RealType *            wid;
+        const RealType *            len;
+        const RealType *            nf;
+        std::size_t                 numInst;
+    };
+/*! @brief Return DeviceView of netlist. */
+    DeviceView                      deviceView() const
+    {
+        return DeviceView{_termNetId.data(), NUM_TERM, _instTypeArray.data(), _mosTypeArray.data(),
+                          _widArray.data(), _lenArray.data(), _nfArray.data(), _instArray.size()};
+    }
 /*! @brief Return Id of Net connected to Inst by certain PinType.
 
     Example: instNetId(0, PinType::DRAIN) would return the net index 
@@ -93,10 +275,18 @@ public:
     connected, INDEX_TYPE_MAX would be returned. Use at risk and 
     only if InstType is known. 
 
+    Terminals other than PinType::OTHER are looked up in
+    a per inst table, OTHER scans the pins of the Inst.
+
     @param instId Id of Inst.
     @param pinType Returned Net Id connected to this PinType.
 */
-    IndexType                       instNetId(IndexType instId, PinType pinType) const;
+    IndexType                       instNetId(IndexType instId, PinType pinType) const
+    {
+        if (pinType == PinType::OTHER)
+            return scanNetId(instId, pinType);
+        return _termNetId[instId * NUM_TERM + static_cast<IndexType>(pinType)];
+    }
 /*! @brief Return Id of Pin with PinType connected to Inst.
 
     Example: instPinId(0,PinType::DRAIN) would return the pin index
@@ -108,7 +298,12 @@ public:
     @param instId Id of Inst.
     @param pinType Returned Pin Id should be this PinType.
 */
-    IndexType                       instPinId(IndexType instId, PinType pinType) const;
+    IndexType                       instPinId(IndexType instId, PinType pinType) const
+    {
+        if (pinType == PinType::OTHER)
+            return scanPinId(instId, pinType);
+        return _termPinId[instId * NUM_TERM + static_cast<IndexType>(pinType)];
+    }
 
 /*! @brief Return Source Net Id of Inst mosId.
     Equivalent as instNetId(mosId, PinType::SOURCE);
@@ -213,10 +408,26 @@ public:
     // Getters
 /*! @brief Return Pin of Id. */
     const Pin &                     pin(IndexType id) const             { return _pinArray.at(id); }
-/*! @brief Return Net of Id. */
-    const Net &                     net(IndexType id) const             { return _netArray.at(id); }
-/*! @brief Return Inst of Id. */
-    const Inst &                    inst(IndexType id) const            { return _instArray.at(id); }
+/*! @brief Return name of Net, view valid while Netlist lives. */
+    std::string_view                netName(IndexType id) const         { return _nameStore.str(_netArray.at(id).nameId()); }
+/*! @brief Return name of Inst, view valid while Netlist lives. */
+    std::string_view                instName(IndexType id) const        { return _nameStore.str(_instArray.at(id).nameId()); }
+/*! @brief Return names of Net and Inst. */
+    const NameStore &               nameStore() const                   { return _nameStore; }
+/*! @brief Return view of Net of Id. @see NetView */
+    NetView                         net(IndexType id) const;
+/*! @brief Return view of Inst of Id. @see InstView */
+    InstView                        inst(IndexType id) const;
+/*! @brief Return pins of Net, view valid until pins are added. */
+    IndexArray                      netPinIdArray(IndexType netId) const
+    {
+        return IndexArray(_netPinId.data() + _netPinOffset[netId], _netPinOffset[netId + 1] - _netPinOffset[netId]);
+    }
+/*! @brief Return pins of Inst, view valid until pins are added. */
+    IndexArray                      instPinIdArray(IndexType instId) const
+    {
+        return IndexArray(_instPinId.data() + _instPinOffset[instId], _instPinOffset[instId + 1] - _instPinOffset[instId]);
+    }
 /*! @brief Return number of Pin. */
     IndexType                       numPin() const                      { return _pinArray.size(); }
 /*! @brief Return number of Net. */
@@ -225,19 +436,139 @@ public:
     IndexType                       numInst() const                     { return _instArray.size(); }
 
     // Setters
-/*! @brief Add Pin to Netlist. */
-    void                            addPin(Pin & pin)                   { _pinArray.push_back(pin); }
-/*! @brief Add Net to Netlist. */
-    void                            addNet(Net & net)                   { _netArray.push_back(net); }
-/*! @brief Add Inst to Netlist. */
-    void                            addInst(Inst & inst)                { _instArray.push_back(inst); }
+/*! @brief Add Net to Netlist. Name handle must be from nameStore(). */
+    void                            addNet(Net & net)                   { _netArray.push_back(net); _connValid = false; }
 
 private:    
-    std::vector<Net>                _netArray;
-    std::vector<Pin>                _pinArray;
-    std::vector<Inst>               _instArray;
+/*! @brief Snapshots read and write the tables below directly. */
+    friend class NetlistSnapshot;
+
+    MappedVector<Net>               _netArray;
+    MappedVector<Pin>               _pinArray;
+    MappedVector<Inst>              _instArray;
+/*! @brief Names of Net and Inst, referred to by handle. */
+    NameStore                       _nameStore;
+/*! @brief CSR connectivity, pins of net i are 
+    _netPinId[_netPinOffset[i]] to _netPinId[_netPinOffset[i+1]].
+*/
+    MappedVector<IndexType>         _netPinOffset, _netPinId;
+/*! @brief CSR connectivity of inst, same layout as net. */
+    MappedVector<IndexType>         _instPinOffset, _instPinId;
+/*! @brief False if pins were added after buildConn(). */
+    bool                            _connValid = true;
+/*! @brief Number of terminal slots per inst, PinType SOURCE to THAT. */
+    static constexpr IndexType      NUM_TERM = 6;
+/*! @brief Terminal table, net and pin Id of the first pin of each 
+    PinType of inst i are at i * NUM_TERM + PinType. INDEX_TYPE_MAX 
+    if the inst has no such pin.
+*/
+    MappedVector<IndexType>         _termNetId, _termPinId;
+/*! @brief Device data of inst i at index i. Kept apart from
+    Inst so size and type matching scan contiguous arrays.
+*/
+    MappedVector<InstType>          _instTypeArray;
+    MappedVector<RealType>          _widArray, _lenArray, _nfArray;
+/*! @brief Cached MosType of each inst. */
+    MappedVector<MosType>           _mosTypeArray;
+    SupplyConfig                    _supplyConfig;
+/*! @brief NetType of each net, set by classifyNet(). */
+    MappedVector<NetType>           _netTypeArray;
+
+/*! @brief Classify all nets with _supplyConfig. */
+    void                            classifyNet();
+/*! @brief Size device data, terminal table and MosType cache to number of inst. */
+    void                            resizeInst();
+/*! @brief Set device data of inst. */
+    void                            setInstData(IndexType instId, InstType type, RealType wid, RealType len, RealType nf);
+/*! @brief Record pin in terminal table and update MosType of its inst. */
+    void                            addTerm(const Pin & pin);
+/*! @brief MosType of inst from its terminal table. */
+    MosType                         termMosType(IndexType instId) const;
+/*! @brief Net Id of first pin of pinType by scanning pins of inst. */
+    IndexType                       scanNetId(IndexType instId, PinType pinType) const;
+/*! @brief Pin Id of first pin of pinType by scanning pins of inst. */
+    IndexType                       scanPinId(IndexType instId, PinType pinType) const;
+};
+
+/*! @class Netlist::NetView
+    @brief Net of a Netlist with its connectivity.
+
+    Net only stores a name handle and an Id, pins are kept
+    by Netlist in CSR form and names in NameStore. The view
+    reads all of them, so netlist.net(id).pinIdArray() and
+    name() work as before. Names are returned as views into
+    the NameStore. Valid while the Netlist lives.
+*/
+class Netlist::NetView
+{
+public:
+    explicit NetView(const Netlist & netlist, IndexType netId)
+        : _netlist(&netlist), _netId(netId)
+    {
+        _netlist->_netArray.at(netId); // Same bounds check as before
+    }
+
+/*! @brief Return Net record. */
+    const Net &                     net() const                         { return _netlist->_netArray[_netId]; }
+/*! @brief Return Id of Net as in input. @see Net::id */
+    IndexType                       id() const                          { return net().id(); }
+/*! @brief Return handle of name. */
+    std::uint32_t                   nameId() const                      { return net().nameId(); }
+/*! @brief Return name of Net. @see Netlist::netName */
+    std::string_view                name() const                        { return _netlist->_nameStore.str(nameId()); }
+/*! @brief Return pins of Net. @see Netlist::netPinIdArray */
+    IndexArray                      pinIdArray() const                  { return _netlist->netPinIdArray(_netId); }
+
+private:
+    const Netlist *                 _netlist;
+    IndexType                       _netId;
 };
 
+/*! @class Netlist::InstView
+    @brief Inst of a Netlist with its connectivity.
+
+    Same as NetView for Inst, netlist.inst(id).pinIdArray()
+    and name() work as before. type(), wid(), len() and nf()
+    read the device arrays of Netlist. Hot loops should
+    scan those arrays directly, see Netlist::DeviceView.
+    Valid while the Netlist lives.
+*/
+class Netlist::InstView
+{
+public:
+    explicit InstView(const Netlist & netlist, IndexType instId)
+        : _netlist(&netlist), _instId(instId)
+    {
+        _netlist->_instArray.at(instId); // Same bounds check as before
+    }
+
+/*! @brief Return Inst record. */
+    const Inst &                    inst() const                        { return _netlist->_instArray[_instId]; }
+/*! @brief Return Id of Inst. */
+    IndexType                       id() const                          { return inst().id(); }
+/*! @brief Return handle of name. */
+    std::uint32_t                   nameId() const                      { return inst().nameId(); }
+/*! @brief Return name of Inst. @see Netlist::instName */
+    std::string_view                name() const                        { return _netlist->_nameStore.str(nameId()); }
+/*! @brief Return type of Inst. @see Netlist::instType */
+    InstType                        type() const                        { return _netlist->instType(_instId); }
+/*! @brief Return width of Inst. */
+    RealType                        wid() const                         { return _netlist->instWid(_instId); }
+/*! @brief Return length of Inst. */
+    RealType                        len() const                         { return _netlist->instLen(_instId); }
+/*! @brief Return number fingers of Inst. */
+    RealType                        nf() const                          { return _netlist->instNf(_instId); }
+/*! @brief Return pins of Inst. @see Netlist::instPinIdArray */
+    IndexArray                      pinIdArray() const                  { return _netlist->instPinIdArray(_instId); }
+
+private:
+    const Netlist *                 _netlist;
+    IndexType                       _instId;
+};
+
+inline Netlist::NetView Netlist::net(IndexType id) const                { return NetView(*this, id); }
+inline Netlist::InstView Netlist::inst(IndexType id) const              { return InstView(*this, id); }
+
 PROJECT_NAMESPACE_END
 
 #endif
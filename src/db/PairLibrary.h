@@ -0,0 +1,167 @@
+/*! @file db/PairLibrary.h
+    @brief Pairs of Ids with hashed membership.
+    @author agent
+    @date 10/16/2026
+*/
+#ifndef __PAIRLIBRARY_H__
+#define __PAIRLIBRARY_H__
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "global/type.h"
+#include "db/MosPair.h"
+#include "db/NetPair.h"
+
+PROJECT_NAMESPACE_BEGIN
+/*! @class PairLibrary
+    @brief Pairs of Ids with hashed membership.
+
+    Stores pairs in insertion order like std::vector, and
+    indexes them so that lookups do not scan the library.
+    Pairs are keyed by the unordered Id pair in an open
+    addressing hash table that holds the position of the
+    first equal pair. Each Id in any pair is marked in a
+    bitmap for lookups by single Id.
+
+    Pairs are only appended. Elements may be modified in
+    place, but not their Ids.
+    @tparam PairType MosPair or NetPair.
+    @tparam Id1 Getter of the first Id.
+    @tparam Id2 Getter of the second Id.
+*/
+template <typename PairType, IndexType (PairType::*Id1)() const, IndexType (PairType::*Id2)() const>
+class PairLibrary
+{
+public:
+    using value_type        = PairType;
+    using iterator          = typename std::vector<PairType>::iterator;
+    using const_iterator    = typename std::vector<PairType>::const_iterator;
+
+/*! @brief Default Constructor, empty library. */
+    explicit PairLibrary() = default;
+
+    iterator                begin()                                 { return _pair.begin(); }
+    iterator                end()                                   { return _pair.end(); }
+    const_iterator          begin() const                           { return _pair.begin(); }
+    const_iterator          end() const                             { return _pair.end(); }
+    std::size_t             size() const                            { return _pair.size(); }
+    bool                    empty() const                           { return _pair.empty(); }
+    PairType &              operator[](std::size_t i)               { return _pair[i]; }
+    const PairType &        operator[](std::size_t i) const         { return _pair[i]; }
+    PairType &              back()                                  { return _pair.back(); }
+/*! @brief Return pairs in insertion order. */
+    const std::vector<PairType> &   pairs() const                   { return _pair; }
+
+/*! @brief Append pair. */
+    void                    push_back(const PairType & pair)
+    {
+        _pair.push_back(pair);
+        index(_pair.size() - 1);
+    }
+/*! @brief Construct pair in place and append. */
+    template <typename... Args>
+    void                    emplace_back(Args &&... args)
+    {
+        _pair.emplace_back(std::forward<Args>(args)...);
+        index(_pair.size() - 1);
+    }
+/*! @brief Remove all pairs, in time linear to size. */
+    void                    clear()
+    {
+        for (const PairType & pair : _pair)
+        {
+            _hasId[(pair.*Id1)()] = false;
+            _hasId[(pair.*Id2)()] = false;
+        }
+        _pair.clear();
+        _table.clear();
+    }
+    void                    swap(PairLibrary & other)
+    {
+        _pair.swap(other._pair);
+        _table.swap(other._table);
+        _hasId.swap(other._hasId);
+    }
+
+/*! @brief Return position of first pair equal to unordered
+    Ids, size() if not in library.
+*/
+    std::size_t             find(IndexType id1, IndexType id2) const
+    {
+        if (_table.empty())
+            return _pair.size();
+        const Slot & slot = _table[findSlot(key(id1, id2))];
+        return slot.key != 0 ? slot.pos : _pair.size();
+    }
+/*! @brief Check if library contains pair of unordered Ids. */
+    bool                    exist(IndexType id1, IndexType id2) const   { return find(id1, id2) != _pair.size(); }
+/*! @brief Check if any pair of library contains id. */
+    bool                    exist(IndexType id) const               { return id < _hasId.size() && _hasId[id]; }
+
+private:
+/*! @brief Initial number of hash table slots. */
+    static constexpr std::size_t    MIN_SLOT = 16;
+
+/*! @struct Slot
+    @brief Hash table slot.
+*/
+    struct Slot
+    {
+        std::uint64_t       key = 0; /*!< 0 if empty. @see key */
+        std::uint32_t       pos = 0; /*!< Position of first equal pair. */
+    };
+
+    std::vector<PairType>   _pair;
+    std::vector<Slot>       _table;
+    std::vector<bool>       _hasId;
+
+/*! @brief Return nonzero key of unordered Ids. */
+    static std::uint64_t    key(IndexType id1, IndexType id2)
+    {
+        return (static_cast<std::uint64_t>(std::min(id1, id2)) << 32 | std::max(id1, id2)) + 1;
+    }
+/*! @brief Return slot of key in _table, empty if not stored. */
+    std::size_t             findSlot(std::uint64_t key) const
+    {
+        std::size_t mask = _table.size() - 1;
+        std::size_t slot = (key * 0x9E3779B97F4A7C15ull) >> 32 & mask; // Fibonacci hashing
+        while (_table[slot].key != 0 && _table[slot].key != key)
+            slot = (slot + 1) & mask; // Linear probing
+        return slot;
+    }
+/*! @brief Add pair at pos to _table and bitmap, _table grows at load 3/4. */
+    void                    index(std::size_t pos)
+    {
+        IndexType id1 = (_pair[pos].*Id1)(), id2 = (_pair[pos].*Id2)();
+        if (std::max(id1, id2) >= _hasId.size())
+            _hasId.resize(std::max<std::size_t>(std::max(id1, id2) + 1, 2 * _hasId.size()), false);
+        _hasId[id1] = true;
+        _hasId[id2] = true;
+        if (4 * _pair.size() > 3 * _table.size())
+        {
+            std::vector<Slot> oldTable(std::max(MIN_SLOT, 2 * _table.size()));
+            oldTable.swap(_table);
+            for (const Slot & old : oldTable)
+                if (old.key != 0)
+                    _table[findSlot(old.key)] = old;
+        }
+        std::uint64_t pairKey = key(id1, id2);
+        Slot & slot = _table[findSlot(pairKey)];
+        if (slot.key == 0) // First of equal pairs wins
+        {
+            slot.key = pairKey;
+            slot.pos = static_cast<std::uint32_t>(pos);
+        }
+    }
+};
+
+/*! @brief Library of MosPair. */
+using MosPairLibrary = PairLibrary<MosPair, &MosPair::mosId1, &MosPair::mosId2>;
+/*! @brief Library of NetPair. */
+using NetPairLibrary = PairLibrary<NetPair, &NetPair::netId1, &NetPair::netId2>;
+
+PROJECT_NAMESPACE_END
+
+#endif
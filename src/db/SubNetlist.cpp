@@ -0,0 +1,57 @@
+/*! @file db/SubNetlist.cpp
+    @brief SubNetlist implementation.
+    @author agent
+    @date 10/16/2026
+*/
+#include "db/SubNetlist.h"
+#include <unordered_map>
+
+PROJECT_NAMESPACE_BEGIN
+
+void SubNetlist::collectNet(const Netlist & netlist, const std::vector<IndexType> & instArray,
+                            std::vector<IndexType> & netArray)
+{
+    netArray.clear();
+    std::unordered_map<IndexType, IndexType> localId;
+    for (IndexType instId : instArray)
+        for (IndexType pinId : netlist.instPinIdArray(instId))
+        {
+            IndexType netId = netlist.pin(pinId).netId();
+            if (localId.emplace(netId, netArray.size()).second)
+                netArray.push_back(netId);
+        }
+}
+
+SubNetlist::SubNetlist(const Netlist & netlist, const std::vector<IndexType> & instArray)
+    : _instMap(instArray)
+{
+    collectNet(netlist, instArray, _netMap);
+    std::unordered_map<IndexType, IndexType> localId;
+    IndexType numPin = 0;
+    for (IndexType instId : instArray)
+        numPin += netlist.instPinIdArray(instId).size();
+    Netlist::Builder builder(_netlist);
+    builder.reserve(_netMap.size(), instArray.size(), numPin);
+    for (IndexType i = 0; i < _netMap.size(); i++)
+    {
+        localId.emplace(_netMap[i], i);
+        builder.addNet(netlist.netName(_netMap[i]), netlist.net(_netMap[i]).id());
+    }
+    for (IndexType instId : instArray)
+    {
+        IndexType localInst = builder.addInst(netlist.instName(instId), netlist.instType(instId),
+                                              netlist.instWid(instId), netlist.instLen(instId), netlist.instNf(instId));
+        for (IndexType pinId : netlist.instPinIdArray(instId))
+        {
+            const Pin & pin = netlist.pin(pinId);
+            _netlist.addInstPin(localInst, localId.at(pin.netId()), pin.type());
+        }
+    }
+// Net types follow parent, they may depend on rules and topology of parent
+    _netlist.setSupplyConfig(netlist.supplyConfig());
+    _netlist.buildConn();
+    for (IndexType i = 0; i < _netMap.size(); i++)
+        _netlist.setNetType(i, netlist.netType(_netMap[i]));
+}
+
+PROJECT_NAMESPACE_END
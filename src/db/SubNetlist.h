@@ -0,0 +1,58 @@
+/*! @file db/SubNetlist.h
+    @brief Induced sub-netlist of a Netlist.
+    @author agent
+    @date 10/16/2026
+*/
+#ifndef __SUBNETLIST_H__
+#define __SUBNETLIST_H__
+
+#include <vector>
+#include "global/type.h"
+#include "db/Netlist.h"
+
+PROJECT_NAMESPACE_BEGIN
+/*! @class SubNetlist
+    @brief Induced sub-netlist of a Netlist.
+
+    Holds a compact Netlist made of a subset of Inst of a
+    parent Netlist and every Net they touch. Names, sizes
+    and PinType are copied, so net classification and 
+    pattern detection behave as in the parent. Local Inst
+    follow the given order and local Net follow the order
+    in which they are first touched by the local pins.
+    instMap() and netMap() translate local Id back to the
+    parent Netlist.
+*/
+class SubNetlist
+{
+public:
+/*! @brief Constructor
+    @param netlist Parent netlist.
+    @param instArray Parent Inst Id to include, in local order.
+*/
+    explicit SubNetlist(const Netlist & netlist, const std::vector<IndexType> & instArray);
+
+    SubNetlist(const SubNetlist &) = delete;
+    SubNetlist & operator=(const SubNetlist &) = delete;
+
+/*! @brief Collect parent Net Id touched by instArray in local order. */
+    static void                     collectNet(const Netlist & netlist, const std::vector<IndexType> & instArray,
+                                        std::vector<IndexType> & netArray);
+
+    // Getters
+/*! @brief Return local netlist. */
+    Netlist &                       netlist()                       { return _netlist; }
+/*! @brief Return parent Inst Id of local Inst Id. */
+    const std::vector<IndexType> &  instMap() const                 { return _instMap; }
+/*! @brief Return parent Net Id of local Net Id. */
+    const std::vector<IndexType> &  netMap() const                  { return _netMap; }
+
+private:
+    Netlist                         _netlist;
+    std::vector<IndexType>          _instMap;
+    std::vector<IndexType>          _netMap;
+};
+
+PROJECT_NAMESPACE_END
+
+#endif
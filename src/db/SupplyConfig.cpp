@@ -0,0 +1,84 @@
+/*! @file db/SupplyConfig.cpp
+    @brief SupplyConfig implementation.
+    @author agent
+    @date 10/16/2026
+*/
+#include "db/SupplyConfig.h"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+PROJECT_NAMESPACE_BEGIN
+
+/*! Default power net names. */
+static const char * POWER_NET_NAMES[] = {"vdd", "VDD", "Vdd", "VDDA", "vdda", "Vdda", "vcc", "AVDD", "vdda1p2"};
+/*! Default ground net names. */
+static const char * GROUND_NET_NAMES[] = {"vss", "VSS", "Vss", "VSSA", "vssa", "Vssa", "gnd", "Gnd", "GND", "AVSS", "gnda", "0"};
+
+SupplyConfig::SupplyConfig()
+{
+    for (const char * name : POWER_NET_NAMES)
+        _nameType.emplace(name, NetType::POWER);
+    for (const char * name : GROUND_NET_NAMES)
+        _nameType.emplace(name, NetType::GROUND);
+}
+
+void SupplyConfig::addRegex(const std::string & regex, NetType type)
+{
+    _regexArray.emplace_back(std::regex(regex, std::regex::ECMAScript | std::regex::optimize), type);
+}
+
+NetType SupplyConfig::nameType(std::string_view name) const
+{
+    auto it = _nameType.find(std::string(name));
+    if (it != _nameType.end())
+        return it->second;
+    for (const auto & rule : _regexArray)
+        if (std::regex_match(name.begin(), name.end(), rule.first))
+            return rule.second;
+    return NetType::SIGNAL;
+}
+
+bool SupplyConfig::read(const std::string & fileName)
+{
+    std::ifstream inFile(fileName.c_str());
+    if (!inFile.is_open())
+    {
+        std::printf("Cannot open file: %s \n", fileName.c_str());
+        return false;
+    }
+    std::string inLine;
+    while (std::getline(inFile, inLine))
+    {
+        std::istringstream lineStream(inLine);
+        std::string key, arg;
+        IndexType num;
+        if (!(lineStream >> key) || key[0] == '#')
+            continue;
+        if (key == "POWER" || key == "GROUND" || key == "SIGNAL")
+        {
+            NetType type = key == "POWER" ? NetType::POWER : key == "GROUND" ? NetType::GROUND : NetType::SIGNAL;
+            while (lineStream >> arg)
+                addName(arg, type);
+        }
+        else if ((key == "POWER_REGEX" || key == "GROUND_REGEX") && lineStream >> arg)
+        {
+            try
+            {
+                addRegex(arg, key == "POWER_REGEX" ? NetType::POWER : NetType::GROUND);
+            }
+            catch (const std::regex_error &)
+            {
+                std::printf("Invalid regex %s in file: %s \n", arg.c_str(), fileName.c_str());
+                return false; // Rule was asked for, do not run without it
+            }
+        }
+        else if (key == "BULK_INFER" && lineStream >> num)
+            setBulkInfer(num);
+        else
+            std::printf("Invalid Syntex in file: %s \n", fileName.c_str());
+    }
+    return true;
+}
+
+PROJECT_NAMESPACE_END
@@ -0,0 +1,73 @@
+/*! @file db/SupplyConfig.h
+    @brief Power/Ground net classification rules.
+    @author agent
+    @date 10/16/2026
+
+    Rules are read from a text file, one rule per line.
+    Lines starting with '#' are comments.
+
+    | Keyword        | Arguments       | Description                          |
+    | -------------- | --------------- | ------------------------------------ |
+    | POWER          | names...        | Nets with these names are power.     |
+    | GROUND         | names...        | Nets with these names are ground.    |
+    | SIGNAL         | names...        | Never classify these as supply.      |
+    | POWER_REGEX    | regex           | Power if whole name matches regex.   |
+    | GROUND_REGEX   | regex           | Ground if whole name matches regex.  |
+    | BULK_INFER     | n               | Supply if n or more bulk pins.       |
+
+    Rules add to the default names (vdd/vss and common
+    variants), a later name rule overrides an earlier or
+    default one. Names go before regex, and regex before
+    topology inference. With BULK_INFER, signal nets not
+    named by a rule and connected to at least n bulk pins
+    are power if most of them are PMOS bulks and ground
+    otherwise. 0 disables it.
+*/
+#ifndef __SUPPLYCONFIG_H__
+#define __SUPPLYCONFIG_H__
+
+#include <regex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "global/type.h"
+
+PROJECT_NAMESPACE_BEGIN
+/*! @class SupplyConfig
+    @brief Power/Ground net classification rules.
+*/
+class SupplyConfig
+{
+public:
+/*! @brief Default Constructor with default supply names. */
+    explicit SupplyConfig();
+
+/*! @brief Add rules from file.
+    Return false if file can not be read or has an invalid regex.
+*/
+    bool                        read(const std::string & fileName);
+/*! @brief Classify name as type. */
+    void                        addName(const std::string & name, NetType type)     { _nameType[name] = type; }
+/*! @brief Classify names that match regex as type. */
+    void                        addRegex(const std::string & regex, NetType type);
+/*! @brief Set bulk pin threshold of topology inference, 0 disables. */
+    void                        setBulkInfer(IndexType numBulkPin)                  { _bulkInfer = numBulkPin; }
+
+    // Getters
+/*! @brief Return NetType by name rules only. */
+    NetType                     nameType(std::string_view name) const;
+/*! @brief Return true if name has a name rule, of any NetType. */
+    bool                        hasName(std::string_view name) const                { return _nameType.count(std::string(name)) > 0; }
+/*! @brief Return bulk pin threshold of topology inference, 0 if disabled. */
+    IndexType                   bulkInfer() const                                   { return _bulkInfer; }
+
+private:
+    std::unordered_map<std::string, NetType>            _nameType;
+    std::vector<std::pair<std::regex, NetType>>         _regexArray;
+    IndexType                   _bulkInfer = 0;
+};
+
+PROJECT_NAMESPACE_END
+
+#endif
@@ -6,7 +6,17 @@
 #ifndef __NAMESPACE_H__
 #define __NAMESPACE_H__
 
+/*! The 16-bit IndexType build lives in its own namespace,
+    so both builds link into one executable.
+    @see global/type.h
+*/
+#if defined(INDEX_TYPE_BITS) && INDEX_TYPE_BITS == 16
+#define PROJECT_NAMESPACE SFA16
+#else
 #define PROJECT_NAMESPACE SFA
+#endif
+#define PROJECT_NAMESPACE_32 SFA
+#define PROJECT_NAMESPACE_16 SFA16
 #define PROJECT_NAMESPACE_BEGIN namespace PROJECT_NAMESPACE {
 #define PROJECT_NAMESPACE_END }
 
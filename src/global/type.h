@@ -11,12 +11,25 @@
 
 PROJECT_NAMESPACE_BEGIN
 
+/*! IndexType is 32-bit unless built with INDEX_TYPE_BITS=16.
+    The 16-bit build halves connectivity and pair memory for
+    netlists with less than INDEX_TYPE_MAX nets, insts and
+    pins. Netlist throws std::length_error beyond that.
+*/
+#if defined(INDEX_TYPE_BITS) && INDEX_TYPE_BITS == 16
+using IndexType     = std::uint16_t;
+#else
 using IndexType     = std::uint32_t;
+#endif
 using IntType       = std::int32_t;
 using RealType      = double;
 using Byte          = std::uint8_t;
 
+#if defined(INDEX_TYPE_BITS) && INDEX_TYPE_BITS == 16
+constexpr IndexType     INDEX_TYPE_MAX          = UINT16_MAX;
+#else
 constexpr IndexType     INDEX_TYPE_MAX          = 1000000000;
+#endif
 constexpr IntType       INT_TYPE_MAX            = 1000000000;
 constexpr IntType       INT_TYPE_MIN            = -1000000000;
 constexpr RealType      REAL_TYPE_MAX           = 1e100;
@@ -93,6 +106,11 @@ enum class MosPattern: Byte
     BIAS, /*!< Bias symmetry pair. */
     INVALID /*!< No pattern detected. */
 };
+
+/*! @brief Set of MosPattern, bit i set for MosPattern i. */
+using PatternMask   = std::uint16_t;
+/*! @brief Return PatternMask with only pattern set. */
+constexpr PatternMask patternBit(MosPattern pattern) { return PatternMask(1) << static_cast<Byte>(pattern); }
     
 PROJECT_NAMESPACE_END
 
@@ -10,6 +10,7 @@
 
 #include <string>
 #include "parser/InitNetlist.h"
+#include "parser/NetlistSnapshot.h"
 #include "sym_detect/SymDetect.h"
 #include "db/Netlist.h"
 
@@ -25,6 +26,25 @@ public:
 
 /*! @brief Read netlist file throught parser initNetlist */
     void    readNetlistFile(const std::string & fileName) { _parser.read(fileName); }
+
+/*! @brief Set number of threads for parsing netlist file. */
+    void    setNumThread(IndexType numThread) { _parser.setNumThread(numThread); }
+
+/*! @brief Read Power/Ground net rules, see db/SupplyConfig.h. */
+    bool    readSupplyConfig(const std::string & fileName)
+    {
+        SupplyConfig config;
+        if (!config.read(fileName))
+            return false;
+        _netlistDB.setSupplyConfig(config);
+        return true;
+    }
+
+/*! @brief Write binary snapshot of current netlist. */
+    bool    saveSnapshot(const std::string & fileName) { return NetlistSnapshot(_netlistDB).write(fileName); }
+
+/*! @brief Load binary snapshot into an empty netlist. */
+    bool    loadSnapshot(const std::string & fileName) { return NetlistSnapshot(_netlistDB).read(fileName); }
     
 /*! @brief Add a net to netlist. */
     IndexType   addNet(const std::string name, IndexType netIdx) { return _netlistDB.addNet(name, netIdx); }
@@ -0,0 +1,90 @@
+/*! @file main/Flow.cpp
+    @brief Detection flow of the ConstGen executable.
+    @author agent
+    @date 10/16/2026
+*/
+#include "main/Flow.h"
+#include <cstdio>
+#include <stdexcept>
+#include "db/SupplyConfig.h"
+#include "parser/InitNetlist.h"
+#include "parser/NetlistSnapshot.h"
+#include "parser/SpiceReader.h"
+#include "sym_detect/SymDetect.h"
+#include "sym_detect/HierSymDetect.h"
+#include "sym_detect/PartSymDetect.h"
+#include "sym_detect/ConeSymDetect.h"
+
+PROJECT_NAMESPACE_BEGIN
+
+/*! @brief Read input into netlist, and hierarchy for SPICE input.
+    @return false on input error.
+*/
+static bool readInput(const FlowOption & option, Netlist & netlist, HierNetlist & hier, bool & hierDetect)
+{
+    if (NetlistSnapshot::isSnapshot(option.inFile))
+    {
+        NetlistSnapshot snapshot(netlist);
+        return snapshot.read(option.inFile); //initialize netlist from snapshot
+    }
+    if (SpiceReader::isSpiceFile(option.inFile))
+    {
+        SpiceReader reader(hier);
+        if (!reader.read(option.inFile) || !hier.flatten(netlist)) //initialize netlist from hierarchy
+            return false;
+        hierDetect = option.hier;
+        return true;
+    }
+    InitNetlist parser = InitNetlist(netlist);
+    parser.setNumThread(option.numThread);
+    return parser.read(option.inFile); //initialize netlist with parser
+}
+
+FlowStatus runFlow(const FlowOption & option)
+{
+    Netlist netlist;
+    HierNetlist hier;
+    bool hierDetect = false;
+    try
+    {
+        if (!readInput(option, netlist, hier, hierDetect))
+            return FlowStatus::FAIL;
+    }
+    catch (const std::length_error &)
+    {
+        return FlowStatus::TOO_LARGE; // Netlist exceeds IndexType
+    }
+    if (!option.supplyFile.empty())
+    {
+        SupplyConfig config;
+        if (!config.read(option.supplyFile))
+            return FlowStatus::FAIL;
+        netlist.setSupplyConfig(config); //classify nets before detection
+    }
+    if (!option.snapshotFile.empty())
+        NetlistSnapshot(netlist).write(option.snapshotFile);
+//    netlist.print_all(); //print netlist
+    bool coneDetect = !option.coneSeed.empty();
+    hierDetect = hierDetect && !coneDetect; // Cone is taken from the flat netlist
+    bool partDetect = option.partition && !hierDetect && !coneDetect;
+    bool flatDetect = !hierDetect && !partDetect && !coneDetect;
+    SymDetect symDetect(netlist, flatDetect, option.cacheSlot, option.numThread, option.levelSrch,
+                        option.mergeGroup); //declare SymDetect
+    if (coneDetect)
+        ConeSymDetect(netlist, option.coneSeed, option.coneDepth).detect(symDetect); //detect around seeds only
+    else if (hierDetect)
+        HierSymDetect(hier, netlist).detect(symDetect); //detect once per subckt master
+    else if (partDetect)
+        PartSymDetect(netlist, option.numThread).detect(symDetect); //detect once per connected component
+    symDetect.print();
+    if (option.cacheSlot != 0 && flatDetect)
+        std::printf("Pattern cache hit %zu miss %zu \n", symDetect.pattern().cacheHit(), symDetect.pattern().cacheMiss());
+    if (!option.outPrefix.empty())
+    {
+        symDetect.dumpSym(option.outPrefix + ".sym");
+        symDetect.dumpNet(option.outPrefix + ".symnet");
+    }
+    return FlowStatus::DONE;
+}
+
+PROJECT_NAMESPACE_END
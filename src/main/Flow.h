@@ -0,0 +1,66 @@
+/*! @file main/Flow.h
+    @brief Detection flow of the ConstGen executable.
+    @author agent
+    @date 10/16/2026
+
+    Flow.cpp is compiled once per IndexType width, into
+    PROJECT_NAMESPACE_32 and PROJECT_NAMESPACE_16. main
+    runs the 16-bit flow first and falls back to 32-bit
+    if the netlist does not fit. Mapped text files and
+    snapshots are rejected from record counts or header
+    before parsing, SPICE and compressed input only once
+    parsed. So declarations here do not depend on
+    IndexType.
+    @see global/type.h
+*/
+#ifndef __FLOW_H__
+#define __FLOW_H__
+
+#include <climits>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "global/namespace.h"
+
+/*! @struct FlowOption
+    @brief Command line options of the flow.
+*/
+struct FlowOption
+{
+    std::string     inFile;
+    std::string     outPrefix;
+    std::string     snapshotFile;
+    std::string     supplyFile;
+    bool            hier = false; /*!< Reuse detection per subckt master for SPICE input. */
+    unsigned        numThread = 1;
+    std::size_t     cacheSlot = 0; /*!< Pattern pair cache slots, 0 if off. */
+    bool            levelSrch = false; /*!< Expand groups level by level. */
+    bool            partition = false; /*!< Detect per connected component. */
+    bool            mergeGroup = false; /*!< Merge groups sharing pairs. */
+    std::vector<std::string>    coneSeed; /*!< Net or Inst patterns, detect around them if any. */
+    unsigned        coneDepth = UINT_MAX; /*!< Steps from cone seeds. */
+};
+
+/*! @enum FlowStatus
+    @brief Result of a flow.
+*/
+enum class FlowStatus
+{
+    DONE, /*!< Output written. */
+    FAIL, /*!< Input error, reported. */
+    TOO_LARGE /*!< Netlist does not fit IndexType, no result was output. */
+};
+
+namespace PROJECT_NAMESPACE_32
+{
+/*! @brief Read netlist, detect symmetry and output. */
+FlowStatus runFlow(const FlowOption & option);
+}
+
+namespace PROJECT_NAMESPACE_16
+{
+/*! @brief Read netlist, detect symmetry and output. */
+FlowStatus runFlow(const FlowOption & option);
+}
+
+#endif
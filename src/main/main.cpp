@@ -8,33 +8,98 @@
     groups and print to command line.
     Input file should be of certain format.
     See parser/InitNetlist.h for details.
+
+    Usage: ConstGen <input> [outPrefix] [options]
+
+    Options:
+    | Option                  | Description                         |
+    | ----------------------- | ----------------------------------- |
+    | -write_snapshot <file>  | Write binary snapshot of netlist.   |
+    | -hier                   | Per-subckt reuse for SPICE input.   |
+    | -threads <n>            | Parse and search on n threads.      |
+    | -supply <file>          | Power/Ground net rules.             |
+    | -pattern_cache <slots>  | Cache pair patterns, 0 if off.      |
+    | -level_search           | Expand groups level by level.       |
+    | -partition              | Detect per connected component.     |
+    | -merge_groups           | Merge groups sharing pairs.         |
+    | -cone <pattern>         | Detect around Net/Inst, repeatable. |
+    | -cone_depth <n>         | Steps from cone seeds.              |
+
+    gzip (.gz) and zstd (.zst) compressed inputs are
+    decompressed while parsing, see parser/CompressedFile.h.
+    Input files starting with the snapshot magic are
+    loaded as binary snapshots instead of being parsed.
+    See parser/NetlistSnapshot.h for details.
+    SPICE/Spectre files (.sp .spi .spice .cir .ckt .cdl 
+    .scs) are flattened. With -hier symmetry is detected
+    once per subckt master, see parser/SpiceReader.h and
+    sym_detect/HierSymDetect.h.
+    With -partition, flat netlists are detected once per
+    component connected through signal nets, see
+    sym_detect/PartSymDetect.h.
+    With -cone, only the region reached from matching
+    Net or Inst names through drain and source is
+    detected, see sym_detect/ConeSymDetect.h.
+    Supply rule file format is in db/SupplyConfig.h.
+    Netlists with less than 65535 nets, insts and pins
+    run on the 16-bit IndexType build, see main/Flow.h.
 */
+#include <algorithm>
+#include <cstdlib>
 #include <string>
 #include <iostream>
-#include "parser/InitNetlist.h"
-#include "sym_detect/SymDetect.h"
+#include "main/Flow.h"
 
 #ifndef __SFA_TEST__
 #define __SFA_TEST__
 
 int main(int argc, char* argv[])
 {
-    using namespace PROJECT_NAMESPACE;
-    Netlist netlist;
-    InitNetlist parser = InitNetlist(netlist);
-    std::string inFile(argv[1]);
-    parser.read(inFile); //initialize netlist with parser
-//    std::cout << "Done!" << std::endl;
-//    netlist.print_all(); //print netlist
-    SymDetect symDetect(netlist); //declare SymDetect
-    symDetect.print();
-    if (argv[2])
+    FlowOption option;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg(argv[i]);
+        if (arg == "-write_snapshot" && i + 1 < argc)
+            option.snapshotFile = argv[++i];
+        else if (arg == "-hier")
+            option.hier = true;
+        else if (arg == "-threads" && i + 1 < argc)
+            option.numThread = std::max(std::atoi(argv[++i]), 1);
+        else if (arg == "-supply" && i + 1 < argc)
+            option.supplyFile = argv[++i];
+        else if (arg == "-pattern_cache" && i + 1 < argc)
+            option.cacheSlot = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "-level_search")
+            option.levelSrch = true;
+        else if (arg == "-partition")
+            option.partition = true;
+        else if (arg == "-merge_groups")
+            option.mergeGroup = true;
+        else if (arg == "-cone" && i + 1 < argc)
+            option.coneSeed.push_back(argv[++i]);
+        else if (arg == "-cone_depth" && i + 1 < argc)
+            option.coneDepth = std::strtoul(argv[++i], nullptr, 10);
+        else if (arg[0] == '-')
+        {
+            std::cout << "Unknown option: " << arg << std::endl;
+            return 1;
+        }
+        else if (option.inFile.empty())
+            option.inFile = arg;
+        else
+            option.outPrefix = arg;
+    }
+    if (option.inFile.empty())
     {
-        std::string file = argv[2];
-        symDetect.dumpSym(file + ".sym");
-        symDetect.dumpNet(file + ".symnet");
+        std::cout << "Usage: ConstGen <input> [outPrefix] [-write_snapshot <file>] [-hier] [-threads <n>] [-supply <file>] [-pattern_cache <slots>] [-level_search] [-partition] [-merge_groups] [-cone <pattern>] [-cone_depth <n>]" << std::endl;
+        return 1;
     }
-    return 0; 
+    FlowStatus status = PROJECT_NAMESPACE_16::runFlow(option); //compact index first
+    if (status == FlowStatus::TOO_LARGE)
+        status = PROJECT_NAMESPACE_32::runFlow(option);
+    if (status == FlowStatus::TOO_LARGE)
+        std::cout << "Netlist too large: " << option.inFile << std::endl;
+    return status == FlowStatus::DONE ? 0 : 1;
 }
 
 #endif
@@ -0,0 +1,166 @@
+/*! @file parser/CompressedFile.cpp
+    @brief CompressedFile implementation.
+    @author agent
+    @date 10/16/2026
+*/
+#include "parser/CompressedFile.h"
+#include <climits>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#ifdef USE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef USE_ZSTD
+#include <zstd.h>
+#endif
+
+PROJECT_NAMESPACE_BEGIN
+
+namespace
+{
+const unsigned char GZIP_MAGIC[2] = {0x1f, 0x8b};
+const unsigned char ZSTD_MAGIC[4] = {0x28, 0xb5, 0x2f, 0xfd};
+/*! @brief Size of zlib internal input buffer. */
+constexpr unsigned GZIP_BUFFER_SIZE = 1 << 17;
+}
+
+/*! Only regular files are probed. Bytes read from a
+    pipe would be lost to the reader that opens it next,
+    so piped input is read as plain text.
+*/
+CompressedFile::Format CompressedFile::format(const std::string & fileName)
+{
+    int fd = ::open(fileName.c_str(), O_RDONLY);
+    if (fd < 0)
+        return Format::NONE;
+    struct stat st;
+    unsigned char magic[4];
+    ssize_t size = ::fstat(fd, &st) == 0 && S_ISREG(st.st_mode) ? ::read(fd, magic, sizeof(magic)) : 0;
+    ::close(fd);
+    if (size >= static_cast<ssize_t>(sizeof(GZIP_MAGIC)) && std::memcmp(magic, GZIP_MAGIC, sizeof(GZIP_MAGIC)) == 0)
+        return Format::GZIP;
+    if (size >= static_cast<ssize_t>(sizeof(ZSTD_MAGIC)) && std::memcmp(magic, ZSTD_MAGIC, sizeof(ZSTD_MAGIC)) == 0)
+        return Format::ZSTD;
+    return Format::NONE;
+}
+
+bool CompressedFile::open(const std::string & fileName)
+{
+    close();
+    _format = format(fileName);
+    _error = false;
+    if (_format == Format::GZIP)
+    {
+#ifdef USE_ZLIB
+        gzFile gz = gzopen(fileName.c_str(), "rb");
+        if (!gz)
+            return false;
+        gzbuffer(gz, GZIP_BUFFER_SIZE);
+        _gz = gz;
+        return true;
+#else
+        std::printf("Built without zlib, cannot read: %s \n", fileName.c_str());
+        return false;
+#endif
+    }
+    if (_format == Format::ZSTD)
+    {
+#ifdef USE_ZSTD
+        ZSTD_DStream * zstd = ZSTD_createDStream();
+        if (!zstd || ZSTD_isError(ZSTD_initDStream(zstd)))
+        {
+            ZSTD_freeDStream(zstd); // Accepts nullptr
+            return false;
+        }
+        _file = std::fopen(fileName.c_str(), "rb");
+        if (!_file)
+        {
+            ZSTD_freeDStream(zstd);
+            return false;
+        }
+        _zstd = zstd;
+        _inBuf.resize(ZSTD_DStreamInSize());
+        _inPos = _inSize = 0;
+        _inFrame = false;
+        return true;
+#else
+        std::printf("Built without zstd, cannot read: %s \n", fileName.c_str());
+        return false;
+#endif
+    }
+    return false;
+}
+
+void CompressedFile::close()
+{
+#ifdef USE_ZLIB
+    if (_gz)
+        gzclose(static_cast<gzFile>(_gz));
+#endif
+#ifdef USE_ZSTD
+    if (_zstd)
+        ZSTD_freeDStream(static_cast<ZSTD_DStream *>(_zstd));
+#endif
+    if (_file)
+        std::fclose(_file);
+    _gz = _zstd = nullptr;
+    _file = nullptr;
+    _format = Format::NONE;
+}
+
+std::size_t CompressedFile::read(char * buf, std::size_t size)
+{
+#ifdef USE_ZLIB
+    if (_gz)
+    {
+        int numRead = gzread(static_cast<gzFile>(_gz), buf, size < INT_MAX ? size : INT_MAX);
+        int errNum = Z_OK;
+        if (numRead <= 0)
+            gzerror(static_cast<gzFile>(_gz), &errNum);
+        if (numRead < 0 || errNum != Z_OK) // Z_BUF_ERROR if truncated
+        {
+            _error = true;
+            return 0;
+        }
+        return numRead;
+    }
+#endif
+#ifdef USE_ZSTD
+    if (_zstd)
+    {
+        ZSTD_outBuffer out = {buf, size, 0};
+        while (out.pos < out.size)
+        {
+            if (_inPos == _inSize)
+            {
+                _inSize = std::fread(_inBuf.data(), 1, _inBuf.size(), _file);
+                _inPos = 0;
+                if (_inSize == 0 && !_inFrame)
+                    break;
+            }
+            ZSTD_inBuffer in = {_inBuf.data(), _inSize, _inPos};
+            std::size_t outPos = out.pos;
+            std::size_t ret = ZSTD_decompressStream(static_cast<ZSTD_DStream *>(_zstd), &out, &in);
+            _inPos = in.pos;
+            if (ZSTD_isError(ret))
+            {
+                _error = true;
+                return 0;
+            }
+            _inFrame = ret != 0;
+// Flushed with no input left and nothing came out
+            if (_inSize == 0 && out.pos == outPos)
+            {
+                _error = _inFrame; // Truncated frame
+                break;
+            }
+        }
+        return out.pos;
+    }
+#endif
+    return 0;
+}
+
+PROJECT_NAMESPACE_END
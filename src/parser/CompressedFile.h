@@ -0,0 +1,86 @@
+/*! @file parser/CompressedFile.h
+    @brief Streaming reader of gzip/zstd compressed files.
+    @author agent
+    @date 10/16/2026
+*/
+#ifndef __COMPRESSEDFILE_H__
+#define __COMPRESSEDFILE_H__
+
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "global/type.h"
+
+PROJECT_NAMESPACE_BEGIN
+/*! @class CompressedFile
+    @brief Streaming reader of gzip/zstd compressed files.
+
+    Decompresses on the fly into caller buffers, so the
+    decompressed file is never held in memory or written
+    to disk. Format is detected by magic bytes, not by
+    extension. gzip needs zlib (USE_ZLIB) and zstd needs
+    libzstd (USE_ZSTD), both detected by CMake.
+*/
+class CompressedFile
+{
+public:
+/*! @enum Format
+    @brief Compression format of a file.
+*/
+    enum class Format : Byte
+    {
+        NONE,
+        GZIP,
+        ZSTD
+    };
+
+public:
+/*! @brief Default Constructor */
+    explicit CompressedFile() = default;
+    ~CompressedFile()                                   { close(); }
+
+    CompressedFile(const CompressedFile &) = delete;
+    CompressedFile & operator=(const CompressedFile &) = delete;
+
+/*! @brief Return compression format of fileName by its magic bytes.
+    NONE if fileName is not a regular file.
+*/
+    static Format       format(const std::string & fileName);
+/*! @brief Return true if fileName is gzip or zstd compressed. */
+    static bool         isCompressed(const std::string & fileName) { return format(fileName) != Format::NONE; }
+
+/*! @brief Open compressed fileName.
+
+    Return false if the file can not be opened or this
+    build has no support for its format.
+*/
+    bool                open(const std::string & fileName);
+/*! @brief Close the file. */
+    void                close();
+/*! @brief Decompress up to size bytes into buf.
+    @return Number of bytes read, 0 at end of file or on error.
+*/
+    std::size_t         read(char * buf, std::size_t size);
+
+    // Getters
+/*! @brief Return true if the file is corrupted or truncated. */
+    bool                error() const                   { return _error; }
+
+private:
+    Format              _format = Format::NONE;
+    bool                _error = false;
+/*! @brief gzFile handle. */
+    void *              _gz = nullptr;
+/*! @brief ZSTD_DStream handle and its compressed input. */
+    void *              _zstd = nullptr;
+    std::FILE *         _file = nullptr;
+    std::vector<char>   _inBuf;
+    std::size_t         _inPos = 0, _inSize = 0;
+/*! @brief True if a zstd frame is not completely decoded. */
+    bool                _inFrame = false;
+};
+
+PROJECT_NAMESPACE_END
+
+#endif
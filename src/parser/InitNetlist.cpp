@@ -3,16 +3,35 @@
     @author Mingjie Liu
     @date 11/24/2018
 */
+#include <algorithm>
 #include <cstdio>
+#include <cstring>
 #include <fstream>
 #include <iostream>
+#include <stdexcept>
+#include <vector>
 #include "InitNetlist.h"
+#include "parser/CompressedFile.h"
+#include "parser/MappedFile.h"
+#include "parser/Tokenizer.h"
 
 PROJECT_NAMESPACE_BEGIN
 
 bool InitNetlist::read(const std::string &fileName)
 {
+    if (CompressedFile::isCompressed(fileName))
+        return readCompressed(fileName);
+    if (_useMmap && readMmap(fileName))
+        return true;
     Netlist::InitDataObj obj; 
+    if (!readStream(fileName, obj))
+        return false;
+    _netlistDB.init(obj);
+    return true;
+}
+
+bool InitNetlist::readStream(const std::string &fileName, Netlist::InitDataObj &obj)
+{
     std::ifstream inFile(fileName.c_str());
     if (!inFile.is_open())
     {
@@ -69,7 +88,285 @@ bool InitNetlist::read(const std::string &fileName)
             std::printf("Invalid Syntex in file: %s \n", fileName.c_str()); 
         inFile.clear();
     }
-    _netlistDB.init(obj);
+    return true;
+}
+
+/*! Count records by the leading keyword of each line.
+    Only used to reserve capacity, so records not at the
+    beginning of a line are allowed to be missed.
+*/
+static void countRecord(const MappedFile &file, std::size_t &numNet, std::size_t &numInst)
+{
+    numNet = numInst = 0;
+    const char *p = file.begin(), *end = file.end();
+    while (p < end)
+    {
+        if (end - p >= 4 && std::memcmp(p, "Inst", 4) == 0)
+            numInst++;
+        else if (end - p >= 3 && std::memcmp(p, "NET", 3) == 0)
+            numNet++;
+        const char *eol = static_cast<const char *>(std::memchr(p, '\n', end - p));
+        if (!eol)
+            break;
+        p = eol + 1;
+    }
+}
+
+/*! Return tokens of an Inst line after name and sizes. */
+static std::size_t countPin(const char *p, const char *eol)
+{
+    std::size_t numToken = 0;
+    const char *type = eol;
+    for (bool inToken = false; p != eol; p++)
+    {
+        if (!inToken && !Tokenizer::isSpace(*p) && ++numToken == 3)
+            type = p;
+        inToken = !Tokenizer::isSpace(*p);
+    }
+    std::size_t numFixed = 4; // Inst, id, type and name
+    if (eol - type >= 4 && (std::memcmp(type, "PMOS", 4) == 0 || std::memcmp(type, "NMOS", 4) == 0))
+        numFixed += 3;
+    else if (eol - type >= 3 && (std::memcmp(type, "CAP", 3) == 0 || std::memcmp(type, "RES", 3) == 0))
+        numFixed += 2;
+    return numToken > numFixed ? numToken - numFixed : 0;
+}
+
+/*! Return true if lines of file hold more nets, insts or
+    pins than INDEX_TYPE_MAX. Counting stops there, so a 
+    file too large for the 16-bit build is rejected after
+    reading its first records. Records not at the beginning
+    of a line are missed and fail later while parsing.
+*/
+static bool exceedIndex(const MappedFile &file)
+{
+    std::size_t numNet = 0, numInst = 0, numPin = 0;
+    const char *p = file.begin(), *end = file.end();
+    while (p < end)
+    {
+        const char *eol = static_cast<const char *>(std::memchr(p, '\n', end - p));
+        if (!eol)
+            eol = end;
+        if (end - p >= 4 && std::memcmp(p, "Inst", 4) == 0)
+        {
+            numInst++;
+            numPin += countPin(p, eol);
+        }
+        else if (end - p >= 3 && std::memcmp(p, "NET", 3) == 0)
+            numNet++;
+        if (numNet > INDEX_TYPE_MAX || numInst > INDEX_TYPE_MAX || numPin > INDEX_TYPE_MAX)
+            return true;
+        p = eol + 1;
+    }
+    return false;
+}
+
+/*! Same grammar as readStream. Records are fed to sink,
+    a Netlist::Builder or Netlist::Chunk. onError is called
+    for every invalid syntax.
+*/
+template <typename Sink, typename OnError>
+static void parseRecord(Tokenizer &tok, Sink &sink, OnError onError)
+{
+    std::string_view inLine;
+    while (tok.next(inLine))
+    {
+        if (inLine == "Inst")
+        {
+            IndexType id;
+            tok.nextIndex(id);
+            tok.next(inLine);
+            InstType instType;
+            if (inLine == "PMOS")
+                instType = InstType::PMOS;
+            else if (inLine == "NMOS")
+                instType = InstType::NMOS;
+            else if (inLine == "CAP")
+                instType = InstType::CAP;
+            else if (inLine == "RES")
+                instType = InstType::RES;
+            else if (inLine == "OTHER")
+                instType = InstType::OTHER;
+            else
+            {
+                onError();
+                continue;
+            }
+            tok.next(inLine);
+            std::string_view name = inLine;
+            RealType wid = 0, len = 0, nf = 1;
+            if (instType == InstType::PMOS || instType == InstType::NMOS)
+            {
+                if (tok.nextReal(wid) && tok.nextReal(len))
+                    tok.nextReal(nf);
+            }
+            else if (instType != InstType::OTHER)
+            {
+                if (tok.nextReal(wid))
+                    tok.nextReal(len);
+            }
+            sink.addInst(name, instType, wid, len, nf);
+            IndexType netId;
+            while (tok.nextIndex(netId))
+                sink.addPin(netId);
+        }
+        else if (inLine == "NET")
+        {
+            IndexType id = INDEX_TYPE_MAX;
+            tok.nextIndex(id);
+            tok.next(inLine);
+            sink.addNet(inLine, id);
+        }
+        else
+            onError();
+    }
+}
+
+/*! Tokens are views into the mapped file and records 
+    are streamed into the Netlist::Builder, so only names 
+    are copied once.
+
+    A file with more records than IndexType holds is 
+    rejected before parsing, so parallel parsing does not
+    run through it first. Files of at most INDEX_TYPE_MAX
+    bytes can not have that many and are not counted.
+*/
+bool InitNetlist::readMmap(const std::string &fileName)
+{
+    MappedFile file;
+    if (!file.open(fileName))
+        return false;
+    if (file.size() > INDEX_TYPE_MAX && exceedIndex(file))
+        throw std::length_error("InitNetlist: netlist does not fit IndexType");
+    if (_numThread > 1)
+        return readParallel(file, fileName);
+    Netlist::Builder builder(_netlistDB);
+    std::size_t numNet, numInst;
+    countRecord(file, numNet, numInst);
+    builder.reserve(numNet, numInst, 4 * numInst);
+    Tokenizer tok(file.begin(), file.end());
+    parseRecord(tok, builder, [&]() { std::printf("Invalid Syntex in file: %s \n", fileName.c_str()); });
+    return true;
+}
+
+/*! Return true if line at p begins with a record keyword. */
+static bool isRecord(const char *p, const char *end)
+{
+    return (end - p > 4 && std::memcmp(p, "Inst", 4) == 0 && Tokenizer::isSpace(p[4])) ||
+           (end - p > 3 && std::memcmp(p, "NET", 3) == 0 && Tokenizer::isSpace(p[3]));
+}
+
+/*! Return start of the first line at or after pos that
+    begins with a record keyword, end if there is none.
+*/
+static const char * recordStart(const MappedFile &file, const char *pos)
+{
+    const char *p = pos, *end = file.end();
+    while (p != end)
+    {
+        if ((p == file.begin() || p[-1] == '\n') && isRecord(p, end))
+            return p;
+        const char *eol = static_cast<const char *>(std::memchr(p, '\n', end - p));
+        if (!eol)
+            break;
+        p = eol + 1;
+    }
+    return end;
+}
+
+/*! The file is cut into chunks at lines starting with a
+    record keyword, a few per thread for load balance. 
+    Chunks are parsed concurrently into Netlist::Chunk 
+    and placed by Netlist::Builder::append(), so the 
+    Netlist is the same as parsed serially. Syntax 
+    errors are reported after parsing, in file order.
+*/
+bool InitNetlist::readParallel(const MappedFile &file, const std::string &fileName)
+{
+    IndexType numChunk = 4 * _numThread;
+    std::vector<const char *> bound(numChunk + 1);
+    bound[0] = file.begin();
+    bound[numChunk] = file.end();
+    for (IndexType i = 1; i < numChunk; i++)
+        bound[i] = recordStart(file, std::max(bound[i - 1], file.begin() + file.size() * i / numChunk));
+    std::vector<Netlist::Chunk> chunkArray(numChunk);
+    std::vector<IndexType> numError(numChunk, 0);
+    std::vector<Byte> tooLarge(numChunk, false); // Exceptions must not leave the parallel loop
+#pragma omp parallel for schedule(dynamic) num_threads(_numThread)
+    for (IndexType i = 0; i < numChunk; i++)
+    {
+        Tokenizer tok(bound[i], bound[i + 1]);
+        try
+        {
+            parseRecord(tok, chunkArray[i], [&]() { numError[i]++; });
+        }
+        catch (const std::length_error &)
+        {
+            tooLarge[i] = true;
+        }
+    }
+    if (std::find(tooLarge.begin(), tooLarge.end(), true) != tooLarge.end())
+        throw std::length_error("InitNetlist: index does not fit IndexType");
+    for (IndexType i = 0; i < numChunk; i++)
+        for (IndexType j = 0; j < numError[i]; j++)
+            std::printf("Invalid Syntex in file: %s \n", fileName.c_str());
+    Netlist::Builder(_netlistDB).append(chunkArray, _numThread);
+    return true;
+}
+
+/*! Initial buffer size for compressed input. */
+static constexpr std::size_t COMPRESSED_BUFFER_SIZE = 1 << 20;
+
+/*! Return start of the last line after begin that 
+    begins with a record keyword, begin if there is none.
+*/
+static const char * lastRecordStart(const char *begin, const char *end)
+{
+    for (const char *p = end; p != begin; p--)
+        if (p[-1] == '\n' && p != end && isRecord(p, end))
+            return p;
+    return begin;
+}
+
+/*! Decompressed text goes through a buffer of fixed size.
+    Each fill is parsed up to the last line starting with
+    a record keyword, so no record is cut, and the rest
+    is carried to the front of the buffer for the next
+    fill. The buffer only grows if a single record is
+    longer than it, so memory does not depend on file
+    size. Records are parsed as in readMmap.
+*/
+bool InitNetlist::readCompressed(const std::string &fileName)
+{
+    CompressedFile inFile;
+    if (!inFile.open(fileName))
+    {
+        std::printf("Cannot open file: %s \n", fileName.c_str());
+        return false;
+    }
+    Netlist::Builder builder(_netlistDB);
+    auto onError = [&]() { std::printf("Invalid Syntex in file: %s \n", fileName.c_str()); };
+    std::vector<char> buffer(COMPRESSED_BUFFER_SIZE);
+    std::size_t size = 0;
+    bool eof = false;
+    while (!eof)
+    {
+        if (size == buffer.size())
+            buffer.resize(2 * buffer.size()); // Record longer than buffer
+        std::size_t numRead = inFile.read(buffer.data() + size, buffer.size() - size);
+        if (inFile.error())
+        {
+            std::printf("Corrupted file: %s \n", fileName.c_str());
+            return false;
+        }
+        eof = numRead == 0;
+        size += numRead;
+        const char *begin = buffer.data(), *end = begin + size;
+        const char *stop = eof ? end : lastRecordStart(begin, end);
+        Tokenizer tok(begin, stop);
+        parseRecord(tok, builder, onError);
+        size = end - stop;
+        std::memmove(buffer.data(), stop, size);
+    }
     return true;
 }
 
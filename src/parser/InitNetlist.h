@@ -12,6 +12,7 @@
 #define __INITNETLIST_H__
 
 #include "db/Netlist.h"
+#include "parser/MappedFile.h"
 
 PROJECT_NAMESPACE_BEGIN
 /*! @class InitNetlist
@@ -35,12 +36,42 @@ public:
     scripts take standardized hspice/spectre netlist 
     files as inputs. 
 
+    gzip and zstd compressed files are decompressed
+    while parsing with bounded memory, no decompressed
+    copy is written. Compression is detected by magic
+    bytes.
+
     @param filename Input file to parse.
 */
     bool read(const std::string &filename);
+/*! @brief Select memory mapped parsing.
+
+    Memory mapped parsing is on by default. Files that 
+    can not be mapped (pipes, empty files) are read 
+    through std::ifstream regardless of this setting.
+*/
+    void setMmap(bool useMmap) { _useMmap = useMmap; }
+/*! @brief Set number of threads for memory mapped parsing.
+
+    With more than one thread the file is split at record
+    boundaries and parts are parsed concurrently. The 
+    Netlist is identical to the serial result. Default 1.
+*/
+    void setNumThread(IndexType numThread) { _numThread = numThread; }
      
 private:
     Netlist & _netlistDB; 
+    bool      _useMmap = true;
+    IndexType _numThread = 1;
+
+/*! @brief Parse file through std::ifstream. */
+    bool readStream(const std::string &filename, Netlist::InitDataObj &obj);
+/*! @brief Parse memory mapped file with Tokenizer into Netlist::Builder. */
+    bool readMmap(const std::string &filename);
+/*! @brief Parse gzip/zstd file through a bounded streaming buffer. */
+    bool readCompressed(const std::string &filename);
+/*! @brief Parse memory mapped file in chunks on _numThread threads. */
+    bool readParallel(const MappedFile &file, const std::string &filename);
 };
 
 
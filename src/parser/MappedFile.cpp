@@ -0,0 +1,44 @@
+/*! @file parser/MappedFile.cpp
+    @brief MappedFile implementation.
+    @author agent
+    @date 10/16/2026
+*/
+#include "parser/MappedFile.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+PROJECT_NAMESPACE_BEGIN
+
+bool MappedFile::open(const std::string & fileName)
+{
+    close();
+    int fd = ::open(fileName.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size == 0)
+    {
+        ::close(fd);
+        return false;
+    }
+    void * addr = ::mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // Mapping stays valid after close.
+    if (addr == MAP_FAILED)
+        return false;
+    ::madvise(addr, st.st_size, MADV_SEQUENTIAL);
+    _data = static_cast<const char *>(addr);
+    _size = st.st_size;
+    return true;
+}
+
+void MappedFile::close()
+{
+    if (_data)
+        ::munmap(const_cast<char *>(_data), _size);
+    _data = nullptr;
+    _size = 0;
+}
+
+PROJECT_NAMESPACE_END
@@ -0,0 +1,59 @@
+/*! @file parser/MappedFile.h
+    @brief Read-only memory mapped file.
+    @author agent
+    @date 10/16/2026
+*/
+#ifndef __MAPPEDFILE_H__
+#define __MAPPEDFILE_H__
+
+#include <cstddef>
+#include <string>
+#include "global/type.h"
+
+PROJECT_NAMESPACE_BEGIN
+/*! @class MappedFile
+    @brief Read-only memory mapped file.
+
+    The whole file is mapped into memory on open
+    and unmapped on destruction. Parsers scan the
+    mapped bytes in place without copying.
+*/
+class MappedFile
+{
+public:
+/*! @brief Default Constructor */
+    explicit MappedFile() = default;
+/*! @brief Constructor that opens fileName. */
+    explicit MappedFile(const std::string & fileName)    { open(fileName); }
+    ~MappedFile()                                       { close(); }
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile & operator=(const MappedFile &) = delete;
+
+/*! @brief Map fileName. Return false if the file could not be mapped.
+
+    Empty files and non regular files (pipes) can not
+    be mapped, callers should fall back to stream reads.
+*/
+    bool                open(const std::string & fileName);
+/*! @brief Unmap the file. */
+    void                close();
+
+    // Getters
+/*! @brief Return true if file is mapped. */
+    bool                valid() const                   { return _data != nullptr; }
+/*! @brief Return first byte of the mapped file. */
+    const char *        begin() const                   { return _data; }
+/*! @brief Return one past the last byte of the mapped file. */
+    const char *        end() const                     { return _data + _size; }
+/*! @brief Return size of the mapped file in bytes. */
+    std::size_t         size() const                    { return _size; }
+
+private:
+    const char *        _data = nullptr;
+    std::size_t         _size = 0;
+};
+
+PROJECT_NAMESPACE_END
+
+#endif
@@ -0,0 +1,352 @@
+/*! @file parser/NetlistSnapshot.cpp
+    @brief NetlistSnapshot implementation.
+    @author agent
+    @date 10/16/2026
+*/
+#include "parser/NetlistSnapshot.h"
+#include <array>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "parser/MappedFile.h"
+
+PROJECT_NAMESPACE_BEGIN
+
+namespace
+{
+/*! @brief Snapshot magic, first 8 bytes of file. */
+const char SNAPSHOT_MAGIC[8] = {'C', 'G', 'S', 'N', 'A', 'P', '\0', '\0'};
+/*! @brief Snapshot format version. */
+constexpr std::uint32_t SNAPSHOT_VERSION = 3;
+/*! @brief Tables start at multiples of ALIGN bytes. */
+constexpr std::uint64_t ALIGN = 8;
+
+struct Header
+{
+    char            magic[8];
+    std::uint32_t   version;
+    std::uint32_t   indexBytes; /*!< sizeof(IndexType) of the writing build. */
+    std::uint64_t   indexMax; /*!< INDEX_TYPE_MAX of the writing build. */
+    std::uint64_t   numNet, numInst, numPin, numName, numBlock;
+    std::uint64_t   checksum; /*!< headerSum of the fields above. */
+};
+/*! @brief Net, Inst and Pin of a build with Ids of type Index, same layout. */
+template <typename Index>
+struct NetRecord
+{
+    std::uint32_t   nameId;
+    Index           id;
+};
+template <typename Index>
+struct InstRecord
+{
+    std::uint32_t   nameId;
+    Index           id;
+};
+template <typename Index>
+struct PinRecord
+{
+    Index           id, instId, netId;
+    PinType         type;
+};
+static_assert(sizeof(NetRecord<IndexType>) == sizeof(Net) && sizeof(InstRecord<IndexType>) == sizeof(Inst) &&
+              sizeof(PinRecord<IndexType>) == sizeof(Pin), "Records must match Net, Inst and Pin");
+static_assert(std::is_trivially_copyable<Net>::value && std::is_trivially_copyable<Inst>::value &&
+              std::is_trivially_copyable<Pin>::value, "Tables are copied as bytes");
+
+/*! @enum Table
+    @brief Tables in file order, names follow as character blocks.
+*/
+enum Table
+{
+    NET, INST, PIN, NET_PIN_OFFSET, NET_PIN_ID, INST_PIN_OFFSET, INST_PIN_ID, TERM_NET_ID, TERM_PIN_ID,
+    INST_TYPE, MOS_TYPE, NET_TYPE, WID, LEN, NF, NAME_OFFSET, BLOCK_SIZE, NUM_TABLE
+};
+
+std::uint64_t alignUp(std::uint64_t pos)    { return (pos + ALIGN - 1) / ALIGN * ALIGN; }
+
+/*! @brief Return bytes of each table written by a build with Ids of type Index. */
+template <typename Index>
+std::array<std::uint64_t, NUM_TABLE> tableSize(const Header & header, std::uint64_t numTerm)
+{
+    std::array<std::uint64_t, NUM_TABLE> size;
+    size[NET] = header.numNet * sizeof(NetRecord<Index>);
+    size[INST] = header.numInst * sizeof(InstRecord<Index>);
+    size[PIN] = header.numPin * sizeof(PinRecord<Index>);
+    size[NET_PIN_OFFSET] = (header.numNet + 1) * sizeof(Index);
+    size[INST_PIN_OFFSET] = (header.numInst + 1) * sizeof(Index);
+    size[NET_PIN_ID] = size[INST_PIN_ID] = header.numPin * sizeof(Index);
+    size[TERM_NET_ID] = size[TERM_PIN_ID] = header.numInst * numTerm * sizeof(Index);
+    size[INST_TYPE] = size[MOS_TYPE] = header.numInst * sizeof(Byte);
+    size[NET_TYPE] = header.numNet * sizeof(Byte);
+    size[WID] = size[LEN] = size[NF] = header.numInst * sizeof(RealType);
+    size[NAME_OFFSET] = header.numName * sizeof(std::uint32_t);
+    size[BLOCK_SIZE] = header.numBlock * sizeof(std::uint64_t);
+    return size;
+}
+
+/*! @brief Write bytes and pad to ALIGN. */
+void writeAligned(std::ofstream & outFile, const void * data, std::uint64_t size)
+{
+    static const char PAD[ALIGN] = {};
+    outFile.write(static_cast<const char *>(data), size);
+    outFile.write(PAD, alignUp(size) - size);
+}
+
+/*! @brief Return Id of this build for Id of file. fileMax is INDEX_TYPE_MAX if sentinel. */
+template <typename Index>
+IndexType toIndex(Index id, Index fileMax, bool sentinel)
+{
+    return sentinel && id == fileMax ? INDEX_TYPE_MAX : static_cast<IndexType>(id);
+}
+
+/*! @brief Convert n Ids of a file of the other width into dst. */
+template <typename Index>
+void copyIndex(const Index * src, std::uint64_t n, MappedVector<IndexType> & dst, Index fileMax, bool sentinel)
+{
+    std::vector<IndexType> id(n);
+    for (std::uint64_t i = 0; i < n; i++)
+        id[i] = toIndex(src[i], fileMax, sentinel);
+    dst = std::move(id);
+}
+
+/*! @brief View n elements of a table in the mapped file. */
+template <typename T>
+void viewTable(const char * src, std::uint64_t n, MappedVector<T> & dst, const std::shared_ptr<const MappedFile> & file)
+{
+    dst.view(reinterpret_cast<const T *>(src), n, file);
+}
+
+/*! @brief Return hash of header fields before checksum. */
+std::uint64_t headerSum(const Header & header)
+{
+    const unsigned char * byte = reinterpret_cast<const unsigned char *>(&header);
+    std::uint64_t sum = 0xcbf29ce484222325ull; // FNV-1a
+    for (std::size_t i = 0; i < offsetof(Header, checksum); i++)
+        sum = (sum ^ byte[i]) * 0x100000001b3ull;
+    return sum;
+}
+}
+
+bool NetlistSnapshot::write(const std::string & fileName) const
+{
+    _netlistDB.buildConn(); // Tables are written as built
+    std::ofstream outFile(fileName, std::ios::binary);
+    if (!outFile.is_open())
+    {
+        std::printf("Cannot open file: %s \n", fileName.c_str());
+        return false;
+    }
+    const Netlist & netlist = _netlistDB;
+    const NameStore & names = netlist._nameStore;
+    Header header;
+    std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    header.version = SNAPSHOT_VERSION;
+    header.indexBytes = sizeof(IndexType);
+    header.indexMax = INDEX_TYPE_MAX;
+    header.numNet = netlist.numNet();
+    header.numInst = netlist.numInst();
+    header.numPin = netlist.numPin();
+    header.numName = names.size();
+    header.numBlock = names._block.size();
+    header.checksum = headerSum(header);
+// Records are value initialized, so padding is written as zero
+    std::vector<NetRecord<IndexType>> netRec(header.numNet);
+    for (IndexType i = 0; i < netlist.numNet(); i++)
+    {
+        netRec[i].nameId = netlist._netArray[i].nameId();
+        netRec[i].id = netlist._netArray[i].id();
+    }
+    std::vector<InstRecord<IndexType>> instRec(header.numInst);
+    for (IndexType i = 0; i < netlist.numInst(); i++)
+    {
+        instRec[i].nameId = netlist._instArray[i].nameId();
+        instRec[i].id = netlist._instArray[i].id();
+    }
+    std::vector<PinRecord<IndexType>> pinRec(header.numPin);
+    for (IndexType i = 0; i < netlist.numPin(); i++)
+    {
+        const Pin & pin = netlist._pinArray[i];
+        pinRec[i].id = pin.id();
+        pinRec[i].instId = pin.instId();
+        pinRec[i].netId = pin.netId();
+        pinRec[i].type = pin.type();
+    }
+// A netlist that never had a record has no offsets yet
+    std::vector<IndexType> emptyOffset(1, 0);
+    const IndexType * netPinOffset = netlist._netPinOffset.empty() ? emptyOffset.data() : netlist._netPinOffset.data();
+    const IndexType * instPinOffset = netlist._instPinOffset.empty() ? emptyOffset.data() : netlist._instPinOffset.data();
+    std::vector<std::uint64_t> blockSize;
+    for (const MappedVector<char> & block : names._block)
+        blockSize.push_back(block.size());
+    const void * table[NUM_TABLE] = {
+        netRec.data(), instRec.data(), pinRec.data(), netPinOffset, netlist._netPinId.data(),
+        instPinOffset, netlist._instPinId.data(), netlist._termNetId.data(), netlist._termPinId.data(),
+        netlist._instTypeArray.data(), netlist._mosTypeArray.data(), netlist._netTypeArray.data(),
+        netlist._widArray.data(), netlist._lenArray.data(), netlist._nfArray.data(),
+        names._offset.data(), blockSize.data()};
+    std::array<std::uint64_t, NUM_TABLE> size = tableSize<IndexType>(header, Netlist::NUM_TERM);
+    writeAligned(outFile, &header, sizeof(header));
+    for (int t = 0; t < NUM_TABLE; t++)
+        writeAligned(outFile, table[t], size[t]);
+    for (const MappedVector<char> & block : names._block)
+        outFile.write(block.data(), block.size());
+    return outFile.good();
+}
+
+/*! Only regular files are probed. Bytes read from a
+    pipe would be lost to the reader that opens it next.
+*/
+bool NetlistSnapshot::isSnapshot(const std::string & fileName)
+{
+    int fd = ::open(fileName.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+    struct stat st;
+    char magic[sizeof(SNAPSHOT_MAGIC)];
+    bool isSnap = ::fstat(fd, &st) == 0 && S_ISREG(st.st_mode) &&
+                  ::read(fd, magic, sizeof(magic)) == sizeof(magic) &&
+                  std::memcmp(magic, SNAPSHOT_MAGIC, sizeof(magic)) == 0;
+    ::close(fd);
+    return isSnap;
+}
+
+/*! Only the header and the table layout are checked,
+    in time independent of netlist size. Tables of the
+    same IndexType width are then viewed in the mapping,
+    which the Netlist keeps alive, so pages are read on
+    first use. Snapshots of the other width are converted
+    Id by Id instead.
+*/
+bool NetlistSnapshot::read(const std::string & fileName)
+{
+    if (_netlistDB.numNet() != 0 || _netlistDB.numInst() != 0 || _netlistDB.numPin() != 0)
+    {
+        std::printf("Snapshot must be loaded into an empty netlist: %s \n", fileName.c_str());
+        return false;
+    }
+    std::shared_ptr<MappedFile> file = std::make_shared<MappedFile>();
+    if (!file->open(fileName) || file->size() < sizeof(Header))
+    {
+        std::printf("Cannot open snapshot: %s \n", fileName.c_str());
+        return false;
+    }
+    const Header & header = *reinterpret_cast<const Header *>(file->begin());
+    if (std::memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0 ||
+        header.version != SNAPSHOT_VERSION || (header.indexBytes != 2 && header.indexBytes != 4))
+    {
+        std::printf("Invalid snapshot version: %s \n", fileName.c_str());
+        return false;
+    }
+// Every record takes at least a byte, so products below can not overflow
+    if (header.checksum != headerSum(header) ||
+        header.numNet > file->size() || header.numInst > file->size() || header.numPin > file->size() ||
+        header.numName == 0 || header.numName > file->size() || header.numBlock > file->size() ||
+        (header.indexBytes == sizeof(IndexType) && header.indexMax != INDEX_TYPE_MAX))
+    {
+        std::printf("Corrupted snapshot: %s \n", fileName.c_str());
+        return false;
+    }
+    if (header.numNet > INDEX_TYPE_MAX || header.numInst > INDEX_TYPE_MAX || header.numPin > INDEX_TYPE_MAX)
+        throw std::length_error("NetlistSnapshot: too many objects for IndexType");
+    bool loaded = header.indexBytes == 2 ? load<std::uint16_t>(file) : load<std::uint32_t>(file);
+    if (!loaded)
+        std::printf("Corrupted snapshot: %s \n", fileName.c_str());
+    return loaded;
+}
+
+template <typename Index>
+bool NetlistSnapshot::load(const std::shared_ptr<const MappedFile> & file)
+{
+    const Header & header = *reinterpret_cast<const Header *>(file->begin());
+    const Index fileMax = static_cast<Index>(header.indexMax);
+    std::array<std::uint64_t, NUM_TABLE> size = tableSize<Index>(header, Netlist::NUM_TERM);
+    std::array<const char *, NUM_TABLE> table;
+    std::uint64_t pos = alignUp(sizeof(Header));
+    for (int t = 0; t < NUM_TABLE; t++)
+    {
+        if (pos + size[t] > file->size())
+            return false;
+        table[t] = file->begin() + pos;
+        pos = alignUp(pos + size[t]);
+    }
+    const std::uint64_t * blockSize = reinterpret_cast<const std::uint64_t *>(table[BLOCK_SIZE]);
+    std::uint64_t blockEnd = pos;
+    for (std::uint64_t b = 0; b < header.numBlock; b++)
+    {
+        if (blockSize[b] > file->size() - blockEnd)
+            return false;
+        blockEnd += blockSize[b];
+    }
+    if (blockEnd != file->size())
+        return false;
+
+    Netlist & netlist = _netlistDB;
+    const NetRecord<Index> * netRec = reinterpret_cast<const NetRecord<Index> *>(table[NET]);
+    const InstRecord<Index> * instRec = reinterpret_cast<const InstRecord<Index> *>(table[INST]);
+    const PinRecord<Index> * pinRec = reinterpret_cast<const PinRecord<Index> *>(table[PIN]);
+    if constexpr (std::is_same<Index, IndexType>::value)
+    {
+        viewTable(table[NET], header.numNet, netlist._netArray, file);
+        viewTable(table[INST], header.numInst, netlist._instArray, file);
+        viewTable(table[PIN], header.numPin, netlist._pinArray, file);
+        viewTable(table[NET_PIN_OFFSET], header.numNet + 1, netlist._netPinOffset, file);
+        viewTable(table[NET_PIN_ID], header.numPin, netlist._netPinId, file);
+        viewTable(table[INST_PIN_OFFSET], header.numInst + 1, netlist._instPinOffset, file);
+        viewTable(table[INST_PIN_ID], header.numPin, netlist._instPinId, file);
+        viewTable(table[TERM_NET_ID], header.numInst * Netlist::NUM_TERM, netlist._termNetId, file);
+        viewTable(table[TERM_PIN_ID], header.numInst * Netlist::NUM_TERM, netlist._termPinId, file);
+    }
+    else
+    {
+        for (std::uint64_t i = 0; i < header.numNet; i++)
+            if (netRec[i].id != fileMax && netRec[i].id > INDEX_TYPE_MAX)
+                throw std::length_error("NetlistSnapshot: Net Id does not fit IndexType");
+        std::vector<Net> netArray;
+        netArray.reserve(header.numNet);
+        for (std::uint64_t i = 0; i < header.numNet; i++)
+            netArray.emplace_back(netRec[i].nameId, toIndex(netRec[i].id, fileMax, true));
+        netlist._netArray = std::move(netArray);
+        std::vector<Inst> instArray;
+        instArray.reserve(header.numInst);
+        for (std::uint64_t i = 0; i < header.numInst; i++)
+            instArray.emplace_back(instRec[i].nameId, static_cast<IndexType>(i));
+        netlist._instArray = std::move(instArray);
+        std::vector<Pin> pinArray;
+        pinArray.reserve(header.numPin);
+        for (std::uint64_t i = 0; i < header.numPin; i++)
+            pinArray.emplace_back(i, pinRec[i].instId, pinRec[i].netId, pinRec[i].type);
+        netlist._pinArray = std::move(pinArray);
+        const Index * termNetId = reinterpret_cast<const Index *>(table[TERM_NET_ID]);
+        const Index * termPinId = reinterpret_cast<const Index *>(table[TERM_PIN_ID]);
+        copyIndex(reinterpret_cast<const Index *>(table[NET_PIN_OFFSET]), header.numNet + 1, netlist._netPinOffset, fileMax, false);
+        copyIndex(reinterpret_cast<const Index *>(table[NET_PIN_ID]), header.numPin, netlist._netPinId, fileMax, false);
+        copyIndex(reinterpret_cast<const Index *>(table[INST_PIN_OFFSET]), header.numInst + 1, netlist._instPinOffset, fileMax, false);
+        copyIndex(reinterpret_cast<const Index *>(table[INST_PIN_ID]), header.numPin, netlist._instPinId, fileMax, false);
+        copyIndex(termNetId, header.numInst * Netlist::NUM_TERM, netlist._termNetId, fileMax, true);
+        copyIndex(termPinId, header.numInst * Netlist::NUM_TERM, netlist._termPinId, fileMax, true);
+    }
+    viewTable(table[INST_TYPE], header.numInst, netlist._instTypeArray, file);
+    viewTable(table[MOS_TYPE], header.numInst, netlist._mosTypeArray, file);
+    viewTable(table[NET_TYPE], header.numNet, netlist._netTypeArray, file);
+    viewTable(table[WID], header.numInst, netlist._widArray, file);
+    viewTable(table[LEN], header.numInst, netlist._lenArray, file);
+    viewTable(table[NF], header.numInst, netlist._nfArray, file);
+    NameStore & names = netlist._nameStore;
+    viewTable(table[NAME_OFFSET], header.numName, names._offset, file);
+    names._block.resize(header.numBlock);
+    for (std::uint64_t b = 0, blockPos = pos; b < header.numBlock; blockPos += blockSize[b++])
+        names._block[b].view(file->begin() + blockPos, blockSize[b], file);
+    names._table.clear(); // Rebuilt by intern() on use
+    netlist._connValid = true;
+    return true;
+}
+
+PROJECT_NAMESPACE_END
@@ -0,0 +1,85 @@
+/*! @file parser/NetlistSnapshot.h
+    @brief Binary snapshot of Netlist.
+    @author agent
+    @date 10/16/2026
+
+    A snapshot is written once from a parsed Netlist and
+    loaded later through mmap instead of re-parsing the
+    text netlist. It holds the tables of Netlist as they
+    are in memory. On load the Netlist views each table
+    in the mapping, so loading reads the header and the
+    name block sizes, and table pages are read on first
+    use. A table is copied only when it is changed, see
+    MappedVector.
+    Layout, all fields native endian, each table starts
+    at a multiple of 8 bytes:
+
+    | Section       | Content                                 |
+    | ------------- | --------------------------------------- |
+    | Header        | magic, version, IndexType width, counts,|
+    |               | checksum of the header                  |
+    | Records       | Net, Inst and Pin arrays                |
+    | Connectivity  | net and inst CSR, terminal tables       |
+    | Device data   | InstType, MosType, NetType, sizes       |
+    | Names         | NameStore handles and block sizes       |
+    | Name blocks   | NameStore characters, block after block |
+
+    Tables use the IndexType of the writing build. The
+    other width is converted Id by Id on load, which
+    copies the Id tables. NetType
+    is kept as classified when written, setting a 
+    SupplyConfig classifies again.
+
+    The version is bumped whenever a table layout changes,
+    older snapshots are then rejected and must be rewritten.
+    Snapshots are trusted like other build outputs. The
+    header checksum, version, IndexType width and table
+    layout against the file size are checked, which
+    rejects stale, truncated and foreign files. Table
+    contents are not checked.
+*/
+#ifndef __NETLISTSNAPSHOT_H__
+#define __NETLISTSNAPSHOT_H__
+
+#include <memory>
+#include <string>
+#include "db/Netlist.h"
+
+PROJECT_NAMESPACE_BEGIN
+
+class MappedFile;
+
+/*! @class NetlistSnapshot
+    @brief Write and load binary snapshot of Netlist.
+*/
+class NetlistSnapshot
+{
+public:
+/*! @brief Constructor with Netlist to write or load. */
+    explicit NetlistSnapshot(Netlist & netlist) : _netlistDB(netlist) {}
+
+/*! @brief Write snapshot of netlist to fileName. */
+    bool            write(const std::string & fileName) const;
+/*! @brief Load snapshot fileName into an empty netlist.
+
+    The header and layout are checked before the netlist
+    is changed, so on false the netlist is left empty.
+    The netlist keeps the file mapped while it views a
+    table. Throws std::length_error if the snapshot does
+    not fit IndexType.
+*/
+    bool            read(const std::string & fileName);
+/*! @brief Return true if fileName is a regular file starting with snapshot magic. */
+    static bool     isSnapshot(const std::string & fileName);
+
+private:
+    Netlist &       _netlistDB;
+
+/*! @brief Check layout and view tables of a snapshot with Ids of type Index. */
+    template <typename Index>
+    bool            load(const std::shared_ptr<const MappedFile> & file);
+};
+
+PROJECT_NAMESPACE_END
+
+#endif
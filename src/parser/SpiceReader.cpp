@@ -0,0 +1,332 @@
+/*! @file parser/SpiceReader.cpp
+    @brief SpiceReader implementation.
+    @author agent
+    @date 10/16/2026
+*/
+#include "parser/SpiceReader.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+
+PROJECT_NAMESPACE_BEGIN
+
+namespace
+{
+std::string toLower(std::string str)
+{
+    std::transform(str.begin(), str.end(), str.begin(), [](unsigned char c) { return std::tolower(c); });
+    return str;
+}
+
+bool endsWith(const std::string & str, const std::string & suffix)
+{
+    return str.size() >= suffix.size() && str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+bool contains(const std::string & str, const char * sub)
+{
+    return str.find(sub) != std::string::npos;
+}
+
+/*! @brief Parse SPICE number with scale suffix, like 0.5u or 2meg. */
+bool parseNumber(const std::string & str, RealType & value)
+{
+    char * stop;
+    double d = std::strtod(str.c_str(), &stop);
+    if (stop == str.c_str())
+        return false;
+    std::string suffix = toLower(stop);
+    if (suffix.compare(0, 3, "meg") == 0)       d *= 1e6;
+    else if (suffix.compare(0, 3, "mil") == 0)  d *= 25.4e-6;
+    else if (!suffix.empty())
+    {
+        switch (suffix[0])
+        {
+            case 't': d *= 1e12; break;
+            case 'g': d *= 1e9; break;
+            case 'k': d *= 1e3; break;
+            case 'm': d *= 1e-3; break;
+            case 'u': d *= 1e-6; break;
+            case 'n': d *= 1e-9; break;
+            case 'p': d *= 1e-12; break;
+            case 'f': d *= 1e-15; break;
+            case 'a': d *= 1e-18; break;
+            default: break; // Unit without scale
+        }
+    }
+    value = d;
+    return true;
+}
+
+/*! @brief Split logical line into tokens. Parentheses separate tokens
+    and "w = 1u" is merged into "w=1u".
+*/
+void tokenize(const std::string & line, std::vector<std::string> & token)
+{
+    token.clear();
+    std::string curr;
+    for (char c : line)
+    {
+        if (std::isspace(static_cast<unsigned char>(c)) || c == '(' || c == ')')
+        {
+            if (!curr.empty())
+                token.push_back(std::move(curr));
+            curr.clear();
+        }
+        else
+            curr.push_back(c);
+    }
+    if (!curr.empty())
+        token.push_back(std::move(curr));
+    std::vector<std::string> merged;
+    for (std::string & tok : token)
+    {
+        if (!merged.empty() && (tok[0] == '=' || merged.back().back() == '='))
+            merged.back() += tok;
+        else
+            merged.push_back(std::move(tok));
+    }
+    token.swap(merged);
+}
+
+/*! @brief InstType of a device from its model name and terminal count. */
+InstType modelType(const std::string & model, IndexType numNet)
+{
+    std::string m = toLower(model);
+    if (m == "resistor")
+        return InstType::RES;
+    if (m == "capacitor")
+        return InstType::CAP;
+    if (contains(m, "pch") || contains(m, "pmos") || contains(m, "pfet"))
+        return InstType::PMOS;
+    if (contains(m, "nch") || contains(m, "nmos") || contains(m, "nfet"))
+        return InstType::NMOS;
+    if (numNet >= 3 && m[0] == 'p')
+        return InstType::PMOS;
+    if (numNet >= 3 && m[0] == 'n')
+        return InstType::NMOS;
+    if (contains(m, "res") || m[0] == 'r')
+        return InstType::RES;
+    if (contains(m, "cap") || contains(m, "mim") || contains(m, "mom") || m[0] == 'c')
+        return InstType::CAP;
+    return InstType::OTHER;
+}
+
+/*! @brief Fill device sizes from name=value parameters. */
+void setSize(HierNetlist::Device & dev, const std::vector<std::string> & param)
+{
+    for (const std::string & p : param)
+    {
+        std::size_t eq = p.find('=');
+        std::string key = toLower(p.substr(0, eq));
+        RealType value = 0;
+        parseNumber(p.substr(eq + 1), value);
+        if (key == "w")
+            dev.wid = value;
+        else if (key == "l")
+            dev.len = value;
+        else if (key == "nf" || key == "fingers")
+            dev.nf = value;
+    }
+}
+}
+
+bool SpiceReader::isSpiceFile(const std::string & fileName)
+{
+    std::string name = toLower(fileName);
+    for (const char * ext : {".sp", ".spi", ".spice", ".cir", ".ckt", ".cdl", ".scs"})
+        if (endsWith(name, ext))
+            return true;
+    return false;
+}
+
+HierNetlist::Subckt & SpiceReader::currSubckt()
+{
+    return _currSubckt == INDEX_TYPE_MAX ? _hier.top() : _hier.subckt(_currSubckt);
+}
+
+bool SpiceReader::read(const std::string & fileName)
+{
+    std::ifstream inFile(fileName.c_str());
+    if (!inFile.is_open())
+    {
+        std::printf("Cannot open file: %s \n", fileName.c_str());
+        return false;
+    }
+    _spectre = endsWith(toLower(fileName), ".scs");
+    _pendingArray.clear();
+    std::string inLine, logical;
+    std::vector<std::string> token;
+    bool contNext = false; // Spectre backslash continuation
+    auto flush = [&]()
+    {
+        tokenize(logical, token);
+        if (!token.empty())
+            parseLine(token);
+        logical.clear();
+    };
+    while (std::getline(inFile, inLine))
+    {
+        std::size_t first = inLine.find_first_not_of(" \t\r");
+        if (first == std::string::npos)
+            continue;
+        if (inLine[first] == '*' || inLine.compare(first, 2, "//") == 0)
+            continue; // Comment line
+        if (!_spectre && inLine[first] == '+')
+        {
+            logical += " " + inLine.substr(first + 1); // SPICE continuation
+            continue;
+        }
+        if (!contNext && !logical.empty())
+            flush();
+        std::size_t cmt = _spectre ? inLine.find("//") : inLine.find_first_of("$;");
+        if (cmt != std::string::npos)
+            inLine.erase(cmt);
+        while (!inLine.empty() && (inLine.back() == '\r' || inLine.back() == ' '))
+            inLine.pop_back();
+        contNext = _spectre && !inLine.empty() && inLine.back() == '\\';
+        if (contNext)
+            inLine.pop_back();
+        logical += " " + inLine;
+    }
+    if (!logical.empty())
+        flush();
+// Spectre instances of subckt masters become SubInst, others are devices.
+    for (Pending & pend : _pendingArray)
+    {
+        HierNetlist::Subckt & owner = pend.owner == INDEX_TYPE_MAX ? _hier.top() : _hier.subckt(pend.owner);
+        if (_hier.subcktId(pend.master) != INDEX_TYPE_MAX)
+            owner.instArray.push_back(HierNetlist::SubInst{pend.dev.name, pend.master, pend.dev.netArray});
+        else
+        {
+            std::string m = toLower(pend.master);
+            if (m == "vsource" || m == "isource" || m == "port")
+                continue; // Stimulus
+            pend.dev.type = modelType(pend.master, pend.dev.netArray.size());
+            owner.deviceArray.push_back(std::move(pend.dev));
+        }
+    }
+    _pendingArray.clear();
+    return true;
+}
+
+void SpiceReader::parseLine(std::vector<std::string> & token)
+{
+    std::string key = toLower(token[0]);
+    if (key == "simulator")
+    {
+        for (const std::string & tok : token)
+            if (toLower(tok) == "lang=spectre")
+                _spectre = true;
+            else if (toLower(tok) == "lang=spice")
+                _spectre = false;
+        return;
+    }
+    if (!_spectre && key[0] == '.')
+    {
+        if (key == ".subckt" || key == ".subcircuit")
+            key = "subckt";
+        else if (key == ".ends")
+            key = "ends";
+        else if (key == ".global")
+            key = "global";
+        else
+            return; // .end, .param, .include, .model and others are ignored
+    }
+    if (_spectre && key == "inline" && token.size() > 1 && toLower(token[1]) == "subckt")
+    {
+        token.erase(token.begin());
+        key = "subckt";
+    }
+    if (key == "subckt")
+    {
+        if (token.size() < 2)
+            return;
+        _currSubckt = _hier.addSubckt(token[1]);
+        HierNetlist::Subckt & subckt = _hier.subckt(_currSubckt);
+        for (IndexType i = 2; i < token.size(); i++)
+        {
+            if (token[i].find('=') != std::string::npos || toLower(token[i]) == "params:")
+                break;
+            subckt.portArray.push_back(token[i]);
+        }
+    }
+    else if (key == "ends")
+        _currSubckt = INDEX_TYPE_MAX;
+    else if (key == "global")
+    {
+        for (IndexType i = 1; i < token.size(); i++)
+            _hier.addGlobal(token[i]);
+    }
+    else if (_spectre && (key == "parameters" || key == "include" || key == "ahdl_include" || key == "model" ||
+                          key == "library" || key == "endlibrary" || key == "section" || key == "endsection" ||
+                          key == "save" || key == "ic" || key == "nodeset" || key == "real" || key == "statistics"))
+        return;
+    else
+        parseInst(token);
+}
+
+void SpiceReader::parseInst(std::vector<std::string> & token)
+{
+    HierNetlist::Device dev;
+    dev.name = token[0];
+    std::vector<std::string> pos, param;
+    for (IndexType i = 1; i < token.size(); i++)
+        (token[i].find('=') == std::string::npos ? pos : param).push_back(token[i]);
+    if (pos.size() < 2)
+        return; // Analyses, options and other statements without nets
+    setSize(dev, param);
+    if (_spectre)
+    {
+        std::string master = pos.back();
+        pos.pop_back();
+        dev.netArray = pos;
+        _pendingArray.push_back(Pending{_currSubckt, std::move(dev), std::move(master)});
+        return;
+    }
+    HierNetlist::Subckt & subckt = currSubckt();
+    switch (std::tolower(static_cast<unsigned char>(dev.name[0])))
+    {
+        case 'm':
+        {
+            std::string model = pos.back();
+            pos.pop_back();
+            if (pos.size() > 4)
+                pos.resize(4);
+            dev.type = modelType(model, 4) == InstType::PMOS ? InstType::PMOS : InstType::NMOS;
+            dev.netArray = pos;
+            subckt.deviceArray.push_back(std::move(dev));
+            break;
+        }
+        case 'r':
+        case 'c':
+        {
+            pos.resize(2);
+            dev.type = std::tolower(static_cast<unsigned char>(dev.name[0])) == 'r' ? InstType::RES : InstType::CAP;
+            dev.netArray = pos;
+            subckt.deviceArray.push_back(std::move(dev));
+            break;
+        }
+        case 'x':
+        {
+            std::string master = pos.back();
+            pos.pop_back();
+            subckt.instArray.push_back(HierNetlist::SubInst{dev.name, master, pos});
+            break;
+        }
+        case 'v': case 'i': case 'e': case 'f': case 'g': case 'h': case 'b': case 'k':
+            break; // Sources and couplings are not part of the circuit
+        default:
+        {
+            pos.pop_back(); // Model or value
+            dev.type = InstType::OTHER;
+            dev.netArray = pos;
+            subckt.deviceArray.push_back(std::move(dev));
+            break;
+        }
+    }
+}
+
+PROJECT_NAMESPACE_END
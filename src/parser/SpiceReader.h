@@ -0,0 +1,72 @@
+/*! @file parser/SpiceReader.h
+    @brief Hierarchical SPICE/Spectre netlist reader.
+    @author agent
+    @date 10/16/2026
+
+    Reads .subckt hierarchies directly into HierNetlist,
+    without the external flattening script. Supported:
+
+    | Statement          | SPICE                          | Spectre                          |
+    | ------------------ | ------------------------------ | -------------------------------- |
+    | Subckt definition  | .subckt name ports / .ends     | subckt name (ports) / ends       |
+    | Mosfet             | Mxx d g s b model w= l= nf=    | name (d g s b) model w= l= nf=   |
+    | Resistor/Capacitor | Rxx/Cxx a b [value] [w= l=]    | name (a b) resistor/capacitor    |
+    | Subckt instance    | Xxx nets... master             | name (nets) master               |
+    | Global nets        | .global nets                   | global nets                      |
+
+    Files ending with .scs are read as Spectre, others as
+    SPICE. "simulator lang=" switches language in place.
+    Mosfet polarity is taken from the model name (pch,
+    pmos, pfet or leading p for PMOS, likewise for NMOS).
+    Parameters that are expressions are read as 0.
+*/
+#ifndef __SPICEREADER_H__
+#define __SPICEREADER_H__
+
+#include <string>
+#include <vector>
+#include "db/HierNetlist.h"
+
+PROJECT_NAMESPACE_BEGIN
+/*! @class SpiceReader
+    @brief Hierarchical SPICE/Spectre netlist reader.
+*/
+class SpiceReader
+{
+public:
+/*! @brief Constructor with HierNetlist to fill. */
+    explicit SpiceReader(HierNetlist & hier) : _hier(hier) {}
+
+/*! @brief Parse file into HierNetlist. */
+    bool                read(const std::string & fileName);
+/*! @brief Return true if fileName has a SPICE/Spectre extension. */
+    static bool         isSpiceFile(const std::string & fileName);
+
+private:
+/*! @struct Pending
+    @brief Spectre statement pending until all subckt names are known.
+*/
+    struct Pending
+    {
+        IndexType               owner;
+        HierNetlist::Device     dev;
+        std::string             master;
+    };
+
+    HierNetlist &       _hier;
+    std::vector<Pending>    _pendingArray;
+    bool                _spectre = false;
+/*! @brief Id of subckt being defined, INDEX_TYPE_MAX at top level. */
+    IndexType           _currSubckt = INDEX_TYPE_MAX;
+
+/*! @brief Parse one logical line, continuations already joined. */
+    void                parseLine(std::vector<std::string> & token);
+/*! @brief Parse a device or subckt instance statement. */
+    void                parseInst(std::vector<std::string> & token);
+/*! @brief Return statements of the current subckt or top level. */
+    HierNetlist::Subckt &  currSubckt();
+};
+
+PROJECT_NAMESPACE_END
+
+#endif
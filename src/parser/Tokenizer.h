@@ -0,0 +1,172 @@
+/*! @file parser/Tokenizer.h
+    @brief Zero-copy whitespace tokenizer.
+    @author agent
+    @date 10/16/2026
+*/
+#ifndef __TOKENIZER_H__
+#define __TOKENIZER_H__
+
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <string_view>
+#include "global/type.h"
+
+PROJECT_NAMESPACE_BEGIN
+/*! @class Tokenizer
+    @brief Zero-copy whitespace tokenizer.
+
+    Scans a character buffer in place. Tokens are returned
+    as std::string_view into the buffer, so the buffer must
+    outlive every returned token. Numeric reads follow the
+    same semantics as std::istream extraction: on failure
+    nothing is consumed and the next read sees the same token.
+*/
+class Tokenizer
+{
+public:
+/*! @brief Constructor
+    @param begin First byte of buffer.
+    @param end One past the last byte of buffer.
+*/
+    explicit Tokenizer(const char * begin, const char * end)
+        : _pos(begin), _end(end)
+    {}
+
+/*! @brief Return true if only whitespace remains. */
+    bool                eof()                           { skipSpace(); return _pos == _end; }
+/*! @brief Return current position in buffer. */
+    const char *        pos() const                     { return _pos; }
+
+/*! @brief Read next token. Return false if end of buffer. */
+    bool                next(std::string_view & token)
+    {
+        skipSpace();
+        if (_pos == _end)
+            return false;
+        const char * begin = _pos;
+        while (_pos != _end && !isSpace(*_pos))
+            ++_pos;
+        token = std::string_view(begin, _pos - begin);
+        return true;
+    }
+
+/*! @brief Read next token as unsigned integer.
+
+    Return false and consume nothing if the next
+    token is not an unsigned integer. Throws 
+    std::length_error if it is above INDEX_TYPE_MAX.
+*/
+    bool                nextIndex(IndexType & value)
+    {
+        skipSpace();
+        const char * p = _pos;
+        if (p == _end || !isDigit(*p))
+            return false;
+        std::uint64_t result = 0;
+        while (p != _end && isDigit(*p) && result <= INDEX_TYPE_MAX)
+            result = result * 10 + (*p++ - '0');
+        if (result > INDEX_TYPE_MAX)
+            throw std::length_error("Tokenizer: index does not fit IndexType");
+        if (p != _end && !isSpace(*p))
+            return false;
+        value = result;
+        _pos = p;
+        return true;
+    }
+
+/*! @brief Read next token as floating point number.
+
+    Plain decimal numbers with a short mantissa are
+    converted exactly without calling strtod. Other
+    forms fall back to strtod on a stack copy so the
+    parsed value is always correctly rounded.
+*/
+    bool                nextReal(RealType & value)
+    {
+        std::string_view token;
+        const char * save = _pos;
+        if (!next(token))
+            return false;
+        if (parseReal(token, value))
+            return true;
+        _pos = save;
+        return false;
+    }
+
+/*! @brief Return true if c separates tokens. */
+    static bool         isSpace(char c)                 { return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' || c == '\f'; }
+
+private:
+    const char *        _pos;
+    const char *        _end;
+
+    static bool         isDigit(char c)                 { return c >= '0' && c <= '9'; }
+    void                skipSpace()                     { while (_pos != _end && isSpace(*_pos)) ++_pos; }
+
+    static bool         parseReal(std::string_view token, RealType & value)
+    {
+        static const double POW10[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                       1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+        const char * p = token.data();
+        const char * end = p + token.size();
+        bool neg = false;
+        if (p != end && (*p == '-' || *p == '+'))
+            neg = (*p++ == '-');
+        std::uint64_t mant = 0;
+        IntType numDigit = 0, exp10 = 0;
+        bool fraction = false;
+        for (; p != end; ++p)
+        {
+            if (*p == '.' && !fraction)
+            {
+                fraction = true;
+                continue;
+            }
+            if (!isDigit(*p))
+                break;
+            mant = mant * 10 + (*p - '0');
+            exp10 -= fraction;
+            if (++numDigit > 15)
+                break; // Too long for the fast path.
+        }
+        bool anyDigit = numDigit > 0;
+        if (anyDigit && numDigit <= 15 && p != end && (*p == 'e' || *p == 'E'))
+        {
+            ++p;
+            bool expNeg = false;
+            if (p != end && (*p == '-' || *p == '+'))
+                expNeg = (*p++ == '-');
+            IntType e = 0;
+            if (p == end || !isDigit(*p))
+                return false;
+            for (; p != end && isDigit(*p) && e < 10000; ++p)
+                e = e * 10 + (*p - '0');
+            exp10 += expNeg ? -e : e;
+        }
+// Exact fast path: mantissa and power of ten are both exact doubles.
+        if (anyDigit && p == end && numDigit <= 15 && exp10 >= -22 && exp10 <= 22)
+        {
+            double d = static_cast<double>(mant);
+            d = exp10 < 0 ? d / POW10[-exp10] : d * POW10[exp10];
+            value = neg ? -d : d;
+            return true;
+        }
+// Slow path with correct rounding.
+        char buf[64];
+        if (token.size() >= sizeof(buf))
+            return false;
+        std::memcpy(buf, token.data(), token.size());
+        buf[token.size()] = '\0';
+        char * stop;
+        double d = std::strtod(buf, &stop);
+        if (stop == buf)
+            return false;
+        value = d;
+        return true;
+    }
+};
+
+PROJECT_NAMESPACE_END
+
+#endif
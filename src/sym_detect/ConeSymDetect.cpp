@@ -0,0 +1,114 @@
+/*! @file sym_detect/ConeSymDetect.cpp
+    @brief ConeSymDetect implementation.
+    @author agent
+    @date 10/16/2026
+*/
+#include "sym_detect/ConeSymDetect.h"
+#include <algorithm>
+#include <iostream>
+#include "db/SubNetlist.h"
+
+PROJECT_NAMESPACE_BEGIN
+
+bool ConeSymDetect::match(std::string_view name, std::string_view pattern)
+{
+    std::size_t i = 0, j = 0;
+    std::size_t star = std::string_view::npos, mark = 0; // Last '*' and name position it resumes
+    while (i < name.size())
+    {
+        if (j < pattern.size() && (pattern[j] == '?' || pattern[j] == name[i]))
+        {
+            i++;
+            j++;
+        }
+        else if (j < pattern.size() && pattern[j] == '*')
+        {
+            star = j++;
+            mark = i;
+        }
+        else if (star != std::string_view::npos)
+        {
+            j = star + 1; // Let last '*' take one more character
+            i = ++mark;
+        }
+        else
+            return false;
+    }
+    while (j < pattern.size() && pattern[j] == '*')
+        j++;
+    return j == pattern.size();
+}
+
+bool ConeSymDetect::isSeed(std::string_view name) const
+{
+    for (const std::string & pattern : _seed)
+        if (match(name, pattern))
+            return true;
+    return false;
+}
+
+void ConeSymDetect::getRegion(std::vector<IndexType> & instArray) const
+{
+    instArray.clear();
+    std::vector<bool> inRegion(_netlist.numInst(), false), vstNet(_netlist.numNet(), false);
+    std::vector<IndexType> currNet, nextNet;
+// Add Inst to region, and its unvisited signal nets through drain, source or passive pins to nextNet
+    auto addInst = [&](IndexType instId)
+    {
+        if (inRegion[instId])
+            return;
+        inRegion[instId] = true;
+        instArray.push_back(instId);
+        for (IndexType pinId : _netlist.instPinIdArray(instId))
+        {
+            const Pin & pin = _netlist.pin(pinId);
+            if (pin.type() == PinType::GATE || pin.type() == PinType::BULK)
+                continue;
+            if (_netlist.isSignal(pin.netId()) && !vstNet[pin.netId()])
+            {
+                vstNet[pin.netId()] = true;
+                nextNet.push_back(pin.netId());
+            }
+        }
+    };
+    for (IndexType netId = 0; netId < _netlist.numNet(); netId++)
+    {
+        if (_netlist.isSignal(netId) && isSeed(_netlist.netName(netId)))
+        {
+            vstNet[netId] = true;
+            currNet.push_back(netId);
+        }
+    }
+    for (IndexType instId = 0; instId < _netlist.numInst(); instId++)
+        if (isSeed(_netlist.instName(instId)))
+            addInst(instId);
+    for (IndexType netId : currNet)
+        for (IndexType pinId : _netlist.netPinIdArray(netId))
+            addInst(_netlist.pin(pinId).instId());
+    for (unsigned step = 0; step < _depth && !nextNet.empty(); step++)
+    {
+        currNet.swap(nextNet);
+        nextNet.clear();
+        for (IndexType netId : currNet)
+            for (IndexType pinId : _netlist.netPinIdArray(netId))
+                addInst(_netlist.pin(pinId).instId());
+    }
+    std::sort(instArray.begin(), instArray.end());
+}
+
+void ConeSymDetect::detect(SymDetect & symDetect) const
+{
+    std::vector<IndexType> instArray;
+    getRegion(instArray);
+    if (instArray.size() >= 2) // Single Inst can not form a pair
+    {
+        SubNetlist sub(_netlist, instArray);
+        SymDetect subDetect(sub.netlist(), symDetect);
+        symDetect.merge(subDetect, sub.instMap(), sub.netMap());
+        symDetect.checkSymNet();
+    }
+    std::cout << "Region detection: " << instArray.size() << " of " << _netlist.numInst()
+              << " devices" << std::endl;
+}
+
+PROJECT_NAMESPACE_END
@@ -0,0 +1,69 @@
+/*! @file sym_detect/ConeSymDetect.h
+    @brief Symmetry detection on a region around seeds.
+    @author agent
+    @date 10/16/2026
+*/
+#ifndef __CONESYMDETECT_H__
+#define __CONESYMDETECT_H__
+
+#include <climits>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "db/Netlist.h"
+#include "sym_detect/SymDetect.h"
+
+PROJECT_NAMESPACE_BEGIN
+/*! @class ConeSymDetect
+    @brief Symmetry detection on a region around seeds.
+
+    Seeds are name patterns of Net or Inst, '*' matches
+    any substring and '?' any character. The region
+    starts with seed Insts and Insts connected to seed
+    Nets. Each step of depth adds the Insts connected to
+    signal Nets on drain, source or passive pins of the
+    region, so supplies are never crossed. The region is
+    copied into a SubNetlist and detected on its own.
+
+    Only the region is searched, nets that leave the
+    region are checked against the whole netlist like
+    HierSymDetect. Work apart from reading and matching
+    names scales with the region.
+*/
+class ConeSymDetect
+{
+public:
+/*! @brief Constructor
+    @param netlist Flat netlist.
+    @param seed Name patterns of seed Net or Inst.
+    @param depth Steps from seeds, unlimited by default.
+*/
+    explicit ConeSymDetect(Netlist & netlist, const std::vector<std::string> & seed, unsigned depth = UINT_MAX)
+        : _netlist(netlist), _seed(seed), _depth(depth)
+    {}
+
+/*! @brief Detect symmetry and merge results into symDetect.
+
+    The region is detected with the options of symDetect.
+    @param symDetect SymDetect constructed on netlist without detection.
+*/
+    void                        detect(SymDetect & symDetect) const;
+/*! @brief Get Insts of the region, ascending.
+    @param instArray Returned Inst Id.
+*/
+    void                        getRegion(std::vector<IndexType> & instArray) const;
+/*! @brief Check if name matches pattern of '*' and '?'. */
+    static bool                 match(std::string_view name, std::string_view pattern);
+
+private:
+    Netlist &                   _netlist;
+    std::vector<std::string>    _seed;
+    unsigned                    _depth = UINT_MAX;
+
+/*! @brief Check if name matches any seed. */
+    bool                        isSeed(std::string_view name) const;
+};
+
+PROJECT_NAMESPACE_END
+
+#endif
@@ -0,0 +1,206 @@
+/*! @file sym_detect/HierSymDetect.cpp
+    @brief HierSymDetect implementation.
+    @author agent
+    @date 10/16/2026
+*/
+#include "sym_detect/HierSymDetect.h"
+#include <algorithm>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <numeric>
+#include "db/SubNetlist.h"
+
+PROJECT_NAMESPACE_BEGIN
+
+void HierSymDetect::signature(const HierNetlist::Occurrence & occ, std::vector<IndexType> & sig,
+                              std::vector<IndexType> & netMap) const
+{
+    std::vector<IndexType> instArray(occ.instEnd - occ.instBegin);
+    std::iota(instArray.begin(), instArray.end(), occ.instBegin);
+    SubNetlist::collectNet(_netlist, instArray, netMap);
+    std::map<IndexType, IndexType> localId;
+    for (IndexType i = 0; i < netMap.size(); i++)
+        localId.emplace(netMap[i], i);
+    sig.clear();
+    sig.push_back(occ.masterId);
+    for (IndexType netId : netMap)
+        sig.push_back(static_cast<IndexType>(_netlist.netType(netId)));
+    for (IndexType instId : instArray)
+        for (IndexType pinId : _netlist.instPinIdArray(instId))
+            sig.push_back(localId.at(_netlist.pin(pinId).netId()));
+}
+
+void HierSymDetect::getBoundary(const std::vector<IndexType> & occOf, std::vector<bool> & boundary) const
+{
+    IndexType numOcc = _hier.occurrenceArray().size();
+    std::vector<IndexType> netOwner(_netlist.numNet(), INDEX_TYPE_MAX);
+    std::vector<bool> portNet(_netlist.numNet(), false);
+    for (IndexType instId = 0; instId < _netlist.numInst(); instId++)
+    {
+        for (IndexType pinId : _netlist.instPinIdArray(instId))
+        {
+            IndexType netId = _netlist.pin(pinId).netId();
+            if (netOwner[netId] == INDEX_TYPE_MAX)
+                netOwner[netId] = occOf[instId];
+            else if (netOwner[netId] != occOf[instId])
+                portNet[netId] = true;
+        }
+    }
+    boundary.assign(_netlist.numInst(), false);
+    for (IndexType instId = 0; instId < _netlist.numInst(); instId++)
+    {
+        if (occOf[instId] == numOcc)
+            continue;
+        for (IndexType pinId : _netlist.instPinIdArray(instId))
+        {
+            IndexType netId = _netlist.pin(pinId).netId();
+            if (portNet[netId] && _netlist.isSignal(netId))
+                boundary[instId] = true;
+        }
+    }
+}
+
+void HierSymDetect::extendProbe(const SymDetect & sub, IndexType instBegin, const std::vector<bool> & boundary,
+                                std::vector<bool> & probe) const
+{
+    for (const std::vector<MosPair> & group : sub.symGroup())
+    {
+        bool reach = false;
+        for (const MosPair & pair : group)
+            reach = reach || boundary[instBegin + pair.mosId1()] || boundary[instBegin + pair.mosId2()];
+        if (!reach)
+            continue;
+        for (const MosPair & pair : group)
+        {
+            probe[instBegin + pair.mosId1()] = true;
+            probe[instBegin + pair.mosId2()] = true;
+        }
+    }
+}
+
+bool HierSymDetect::flattenCross(const SymDetect & probe, const std::vector<IndexType> & instMap,
+                                 const std::vector<IndexType> & occOf, std::vector<bool> & flat) const
+{
+    IndexType numOcc = flat.size();
+    auto owner = [&](IndexType subInstId)
+    {
+        IndexType occId = occOf[instMap[subInstId]];
+        return occId == numOcc || flat[occId] ? numOcc : occId;
+    };
+    bool found = false;
+    for (const std::vector<MosPair> & group : probe.symGroup())
+    {
+        IndexType first = owner(group.front().mosId1());
+        bool cross = false;
+        for (const MosPair & pair : group)
+            cross = cross || owner(pair.mosId1()) != first || owner(pair.mosId2()) != first;
+        if (!cross)
+            continue;
+        for (const MosPair & pair : group)
+        {
+            for (IndexType occId : {owner(pair.mosId1()), owner(pair.mosId2())})
+            {
+                if (occId != numOcc)
+                {
+                    flat[occId] = true;
+                    found = true;
+                }
+            }
+        }
+    }
+    return found;
+}
+
+void HierSymDetect::detect(SymDetect & symDetect) const
+{
+    const std::vector<HierNetlist::Occurrence> & occArray = _hier.occurrenceArray();
+    IndexType numOcc = occArray.size();
+    std::vector<IndexType> numUse(_hier.numSubckt(), 0);
+    for (const HierNetlist::Occurrence & occ : occArray)
+        numUse[occ.masterId]++;
+// Select outermost occurrences of masters used more than once, group by signature. 
+    std::map<std::vector<IndexType>, IndexType> classId;
+    std::vector<std::vector<IndexType>> classOcc; // occurrence Id by class
+    std::vector<std::vector<IndexType>> occNetMap(numOcc);
+    std::vector<IndexType> occOf(_netlist.numInst(), numOcc); // Selected occurrence of Inst, numOcc if none
+    IndexType coverEnd = 0;
+    std::vector<IndexType> sig;
+    for (IndexType i = 0; i < numOcc; i++)
+    {
+        const HierNetlist::Occurrence & occ = occArray[i];
+        if (occ.instBegin < coverEnd || occ.instBegin == occ.instEnd || numUse[occ.masterId] < 2)
+            continue;
+        coverEnd = occ.instEnd;
+        std::fill(occOf.begin() + occ.instBegin, occOf.begin() + occ.instEnd, i);
+        signature(occ, sig, occNetMap[i]);
+        auto it = classId.emplace(sig, classOcc.size()).first;
+        if (it->second == classOcc.size())
+            classOcc.emplace_back();
+        classOcc[it->second].push_back(i);
+    }
+// Detect once per class. Groups reaching boundary devices join the probe with their seeds. 
+    std::vector<bool> boundary, flat(numOcc, false);
+    getBoundary(occOf, boundary);
+    std::vector<bool> probeInst(boundary);
+    std::vector<std::unique_ptr<SubNetlist>> classSub;
+    std::vector<std::unique_ptr<SymDetect>> classDetect;
+    std::vector<IndexType> instArray;
+    for (const std::vector<IndexType> & members : classOcc)
+    {
+        const HierNetlist::Occurrence & rep = occArray[members.front()];
+        instArray.resize(rep.instEnd - rep.instBegin);
+        std::iota(instArray.begin(), instArray.end(), rep.instBegin);
+        classSub.emplace_back(new SubNetlist(_netlist, instArray));
+        classDetect.emplace_back(new SymDetect(classSub.back()->netlist(), symDetect));
+        for (IndexType occId : members)
+            extendProbe(*classDetect.back(), occArray[occId].instBegin, boundary, probeInst);
+    }
+// Flatten occurrences with devices paired outside, until the stitching pairs no more of them. 
+    std::vector<IndexType> glue;
+    bool probe = std::find(probeInst.begin(), probeInst.end(), true) != probeInst.end();
+    while (probe)
+    {
+        glue.clear();
+        for (IndexType instId = 0; instId < _netlist.numInst(); instId++)
+            if (occOf[instId] == numOcc || flat[occOf[instId]] || probeInst[instId])
+                glue.push_back(instId);
+        SubNetlist sub(_netlist, glue);
+        SymDetect probeDetect(sub.netlist(), symDetect);
+        probe = flattenCross(probeDetect, sub.instMap(), occOf, flat);
+    }
+// Map each class onto every occurrence left. 
+    IndexType numReuse = 0, numMaster = 0;
+    for (IndexType classIdx = 0; classIdx < classOcc.size(); classIdx++)
+    {
+        std::vector<IndexType> & members = classOcc[classIdx];
+        members.erase(std::remove_if(members.begin(), members.end(), [&](IndexType occId) { return flat[occId]; }),
+                      members.end());
+        if (members.empty())
+            continue;
+        instArray.resize(classSub[classIdx]->instMap().size());
+        for (IndexType occId : members)
+        {
+            std::iota(instArray.begin(), instArray.end(), occArray[occId].instBegin);
+            symDetect.merge(*classDetect[classIdx], instArray, occNetMap[occId]);
+        }
+        numReuse += members.size();
+        numMaster++;
+    }
+// Stitching and flattened occurrences at the flat level. 
+    glue.clear();
+    for (IndexType instId = 0; instId < _netlist.numInst(); instId++)
+        if (occOf[instId] == numOcc || flat[occOf[instId]])
+            glue.push_back(instId);
+    if (!glue.empty())
+    {
+        SubNetlist sub(_netlist, glue);
+        SymDetect subDetect(sub.netlist(), symDetect);
+        symDetect.merge(subDetect, sub.instMap(), sub.netMap());
+    }
+    symDetect.checkSymNet();
+    std::cout << "Hierarchical detection: " << numMaster << " masters for " << numReuse
+              << " instances, " << glue.size() << " flat devices" << std::endl;
+}
+
+PROJECT_NAMESPACE_END
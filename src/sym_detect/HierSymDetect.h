@@ -0,0 +1,90 @@
+/*! @file sym_detect/HierSymDetect.h
+    @brief Symmetry detection with per-master reuse.
+    @author agent
+    @date 10/16/2026
+*/
+#ifndef __HIERSYMDETECT_H__
+#define __HIERSYMDETECT_H__
+
+#include "db/HierNetlist.h"
+#include "sym_detect/SymDetect.h"
+
+PROJECT_NAMESPACE_BEGIN
+/*! @class HierSymDetect
+    @brief Symmetry detection with per-master reuse.
+
+    Subckt occurrences whose master is instantiated more
+    than once are detected once per master and connection
+    signature, and the result is mapped onto every such
+    occurrence. Two occurrences share a signature when
+    their pins connect to local nets in the same pattern
+    and those nets have the same NetType, which makes
+    their sub-netlists identical up to Id translation.
+    Nested occurrences inside a reused one are covered by
+    it. All remaining Inst, the stitching between reused
+    occurrences, are detected together at the flat level.
+
+    Devices may pair across occurrences, like two half
+    circuits of a differential stage. The stitching is
+    first detected with the boundary devices of every
+    occurrence, those on a signal net leaving it, and 
+    with every group of its class result that reaches a 
+    boundary device. A search seeded deep inside an 
+    occurrence can only leave it through such a group, 
+    which brings its seed along. An occurrence with a 
+    device grouped with any device outside of it is 
+    flattened into the stitching, and this repeats until
+    no more occurrences are flattened.
+*/
+class HierSymDetect
+{
+public:
+/*! @brief Constructor
+    @param hier Hierarchy that was flattened into netlist.
+    @param netlist Flat netlist.
+*/
+    explicit HierSymDetect(const HierNetlist & hier, Netlist & netlist)
+        : _hier(hier), _netlist(netlist)
+    {}
+
+/*! @brief Detect symmetry and merge results into symDetect.
+
+    Sub-netlists are detected with the options of symDetect.
+    @param symDetect SymDetect constructed on the flat netlist without detection.
+*/
+    void                        detect(SymDetect & symDetect) const;
+
+private:
+    const HierNetlist &         _hier;
+    Netlist &                   _netlist;
+
+/*! @brief Connection signature of Inst range. Also returns touched nets. */
+    void                        signature(const HierNetlist::Occurrence & occ, std::vector<IndexType> & sig,
+                                    std::vector<IndexType> & netMap) const;
+/*! @brief Mark Insts of selected occurrences on signal nets that leave them.
+    @param occOf Selected occurrence of each Inst, number of occurrences if none.
+    @param boundary Returned flag by Inst Id.
+*/
+    void                        getBoundary(const std::vector<IndexType> & occOf, std::vector<bool> & boundary) const;
+/*! @brief Add devices of groups that reach boundary devices of an occurrence.
+    @param sub SymDetect run on the class of the occurrence.
+    @param instBegin First Inst Id of the occurrence.
+    @param boundary Boundary flag by Inst Id.
+    @param probe Probed flag by Inst Id, updated.
+*/
+    void                        extendProbe(const SymDetect & sub, IndexType instBegin, const std::vector<bool> & boundary,
+                                    std::vector<bool> & probe) const;
+/*! @brief Flatten occurrences grouped with devices outside of them.
+    @param probe SymDetect run on the stitching with probed devices.
+    @param instMap Inst Id of netlist by Inst Id of probe.
+    @param occOf Selected occurrence of each Inst.
+    @param flat Flattened flag by occurrence Id, updated.
+    @return true if an occurrence was newly flattened.
+*/
+    bool                        flattenCross(const SymDetect & probe, const std::vector<IndexType> & instMap,
+                                    const std::vector<IndexType> & occOf, std::vector<bool> & flat) const;
+};
+
+PROJECT_NAMESPACE_END
+
+#endif
@@ -0,0 +1,65 @@
+/*! @file sym_detect/PartSymDetect.cpp
+    @brief PartSymDetect implementation.
+    @author agent
+    @date 10/16/2026
+*/
+#include "sym_detect/PartSymDetect.h"
+#include <algorithm>
+#include <iostream>
+#include "db/DisjointSet.h"
+#include "db/SubNetlist.h"
+
+PROJECT_NAMESPACE_BEGIN
+
+void PartSymDetect::getComponent(std::vector<std::vector<IndexType>> & comp) const
+{
+    DisjointSet instSet(_netlist.numInst());
+    for (IndexType netId = 0; netId < _netlist.numNet(); netId++)
+    {
+        if (!_netlist.isSignal(netId))
+            continue; // Supply nets do not join components
+        IndexArray pinIdArray = _netlist.netPinIdArray(netId);
+        for (IndexType pinId : pinIdArray)
+            instSet.unite(_netlist.pin(pinIdArray.front()).instId(), _netlist.pin(pinId).instId());
+    }
+    comp.clear();
+    std::vector<std::uint32_t> compId(_netlist.numInst(), UINT32_MAX); // By representative
+    for (IndexType instId = 0; instId < _netlist.numInst(); instId++)
+    {
+        std::uint32_t root = instSet.find(instId);
+        if (compId[root] == UINT32_MAX)
+        {
+            compId[root] = comp.size();
+            comp.emplace_back();
+        }
+        comp[compId[root]].push_back(instId);
+    }
+}
+
+void PartSymDetect::detect(SymDetect & symDetect) const
+{
+    std::vector<std::vector<IndexType>> comp;
+    getComponent(comp);
+// Single Inst can not form a pair
+    comp.erase(std::remove_if(comp.begin(), comp.end(), [](const std::vector<IndexType> & instArray)
+    {
+        return instArray.size() < 2;
+    }), comp.end());
+    std::size_t maxComp = 0;
+    for (const std::vector<IndexType> & instArray : comp)
+        maxComp = std::max(maxComp, instArray.size());
+#pragma omp parallel for ordered schedule(dynamic) num_threads(_numThread)
+    for (std::size_t i = 0; i < comp.size(); i++)
+    {
+        SubNetlist sub(_netlist, comp[i]);
+        SymDetect subDetect(sub.netlist(), symDetect);
+#pragma omp ordered
+        symDetect.merge(subDetect, sub.instMap(), sub.netMap());
+    }
+    symDetect.checkSymNet();
+    symDetect.checkSelfSymNet();
+    std::cout << "Partitioned detection: " << comp.size() << " components, largest " << maxComp
+              << " devices" << std::endl;
+}
+
+PROJECT_NAMESPACE_END
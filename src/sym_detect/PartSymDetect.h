@@ -0,0 +1,62 @@
+/*! @file sym_detect/PartSymDetect.h
+    @brief Symmetry detection per connected component.
+    @author agent
+    @date 10/16/2026
+*/
+#ifndef __PARTSYMDETECT_H__
+#define __PARTSYMDETECT_H__
+
+#include <vector>
+#include "db/Netlist.h"
+#include "sym_detect/SymDetect.h"
+
+PROJECT_NAMESPACE_BEGIN
+/*! @class PartSymDetect
+    @brief Symmetry detection per connected component.
+
+    Insts are partitioned into connected components of
+    the netlist without its power and ground nets. Each
+    component of two or more Inst is copied into a
+    SubNetlist and detected on its own, components run
+    concurrently. Results are merged back in component
+    order and each sub-netlist is freed once merged, so
+    peak memory follows the largest component.
+
+    Pairs whose Insts only meet through supply nets are
+    not searched, unlike flat detection. Sub-netlists
+    order pins by Inst, so a pair may be reported with
+    its Insts swapped.
+*/
+class PartSymDetect
+{
+public:
+/*! @brief Constructor
+    @param netlist Flat netlist.
+    @param numThread Components detected concurrently.
+*/
+    explicit PartSymDetect(Netlist & netlist, unsigned numThread = 1)
+        : _netlist(netlist), _numThread(numThread)
+    {}
+
+/*! @brief Detect symmetry and merge results into symDetect.
+
+    Components are detected with the options of symDetect.
+    @param symDetect SymDetect constructed on netlist without detection.
+*/
+    void                        detect(SymDetect & symDetect) const;
+/*! @brief Get connected components of signal nets.
+
+    Components are ordered by their first Inst, Insts of
+    a component are ascending.
+    @param comp Inst Id by component.
+*/
+    void                        getComponent(std::vector<std::vector<IndexType>> & comp) const;
+
+private:
+    Netlist &                   _netlist;
+    unsigned                    _numThread = 1;
+};
+
+PROJECT_NAMESPACE_END
+
+#endif
@@ -4,142 +4,301 @@
     @date 11/24/2018
 */
 #include "sym_detect/Pattern.h"
+#include <algorithm>
+#include <climits>
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+#define PATTERN_AVX2
+#endif
 
 PROJECT_NAMESPACE_BEGIN
 
 bool Pattern::matchedType(IndexType mosId1, IndexType mosId2) const
 {
-    return _netlist.inst(mosId1).type() == _netlist.inst(mosId2).type();
+    return _netlist.instType(mosId1) == _netlist.instType(mosId2);
 }
     
 bool Pattern::matchedSize(IndexType mosId1, IndexType mosId2) const
 {
-    if (_netlist.inst(mosId1).wid() != _netlist.inst(mosId2).wid())
+    if (_netlist.instWid(mosId1) != _netlist.instWid(mosId2))
         return false;
-    if (_netlist.inst(mosId1).len() != _netlist.inst(mosId2).len())
+    if (_netlist.instLen(mosId1) != _netlist.instLen(mosId2))
         return false;
-    if (_netlist.inst(mosId1).nf() != _netlist.inst(mosId2).nf())
+    if (_netlist.instNf(mosId1) != _netlist.instNf(mosId2))
         return false;
     return true;
 }
 
-bool Pattern::diffPairInput(IndexType mosId1, IndexType mosId2) const
+/*! @brief Relation bits of a mosfet pair. @see Pattern::relation */
+enum RelationBit : unsigned
 {
-    if (_netlist.srcNetId(mosId1) == _netlist.srcNetId(mosId2) && 
-        _netlist.gateNetId(mosId1) != _netlist.gateNetId(mosId2) && 
-        _netlist.drainNetId(mosId1) != _netlist.drainNetId(mosId2) && 
-        _netlist.mosType(mosId1) == MosType::DIFF && 
-        _netlist.mosType(mosId2) == MosType::DIFF)
-        return true;
-    if (_netlist.srcNetId(mosId1) != _netlist.srcNetId(mosId2) && 
-        _netlist.gateNetId(mosId1) != _netlist.gateNetId(mosId2) && 
-        _netlist.drainNetId(mosId1) == _netlist.drainNetId(mosId2) && 
-        _netlist.mosType(mosId1) == MosType::DIFF && 
-        _netlist.mosType(mosId2) == MosType::DIFF)
-        return true;
-    return false;
+    SRC_EQ          = 1 << 0,
+    GATE_EQ         = 1 << 1,
+    DRAIN_EQ        = 1 << 2,
+    GATE1_DRAIN2    = 1 << 3,
+    DRAIN1_GATE2    = 1 << 4
+};
+/*! @brief Shift of MosType of mosId1 and mosId2 in relation bits. */
+constexpr unsigned MOS_TYPE1_SHIFT = 5;
+constexpr unsigned MOS_TYPE2_SHIFT = 7;
+/*! @brief Number of relation bit combinations. */
+constexpr unsigned NUM_RELATION = 1 << 9;
+
+/*! @brief Return MosPattern of relation bits.
+
+    Predicates are in order of precedence, as formerly
+    evaluated one after the other on the Netlist.
+*/
+static constexpr MosPattern relationRule(unsigned rel)
+{
+    bool src = rel & SRC_EQ, gate = rel & GATE_EQ, drain = rel & DRAIN_EQ;
+    bool cross = (rel & GATE1_DRAIN2) && (rel & DRAIN1_GATE2);
+    MosType mos1 = static_cast<MosType>(rel >> MOS_TYPE1_SHIFT & 3);
+    MosType mos2 = static_cast<MosType>(rel >> MOS_TYPE2_SHIFT & 3);
+    bool diff = mos1 == MosType::DIFF && mos2 == MosType::DIFF;
+    bool load = (mos1 == MosType::DIFF || mos1 == MosType::DIODE) &&
+                (mos2 == MosType::DIFF || mos2 == MosType::DIODE);
+    bool diode = mos1 == MosType::DIODE && mos2 == MosType::DIODE;
+    if (!src && cross && diff)
+        return MosPattern::CROSS_CASCODE;
+    if (src && cross && diff)
+        return MosPattern::CROSS_LOAD;
+    if (load && !src && gate && !drain)
+        return MosPattern::CASCODE;
+    if (load && src && !drain && (gate || diode))
+        return MosPattern::LOAD;
+    if (diff && !gate && src != drain)
+        return MosPattern::DIFF_SOURCE; // Common source or common drain
+    if (diff && !src && !gate && !drain)
+        return MosPattern::DIFF_CASCODE;
+    if (mos1 == MosType::CAP && mos2 == MosType::CAP)
+        return MosPattern::PASSIVE; // Matched cap
+    return MosPattern::INVALID;
+}
+
+/*! @brief Lookup table of relationRule. */
+struct RelationTable
+{
+    MosPattern pattern[NUM_RELATION] = {};
+
+    constexpr RelationTable()
+    {
+        for (unsigned rel = 0; rel < NUM_RELATION; rel++)
+            pattern[rel] = relationRule(rel);
+    }
+};
+static constexpr RelationTable RELATION_TABLE;
+
+unsigned Pattern::relation(IndexType mosId1, IndexType mosId2) const
+{
+    IndexType src1 = _netlist.srcNetId(mosId1), src2 = _netlist.srcNetId(mosId2);
+    IndexType gate1 = _netlist.gateNetId(mosId1), gate2 = _netlist.gateNetId(mosId2);
+    IndexType drain1 = _netlist.drainNetId(mosId1), drain2 = _netlist.drainNetId(mosId2);
+    return (src1 == src2 ? SRC_EQ : 0) | (gate1 == gate2 ? GATE_EQ : 0) | (drain1 == drain2 ? DRAIN_EQ : 0) |
+           (gate1 == drain2 ? GATE1_DRAIN2 : 0) | (drain1 == gate2 ? DRAIN1_GATE2 : 0) |
+           static_cast<unsigned>(_netlist.mosType(mosId1)) << MOS_TYPE1_SHIFT |
+           static_cast<unsigned>(_netlist.mosType(mosId2)) << MOS_TYPE2_SHIFT;
 }
 
-bool Pattern::diffPairCascode(IndexType mosId1, IndexType mosId2) const
+MosPattern Pattern::relationPattern(unsigned relation)
 {
-    if (_netlist.srcNetId(mosId1) != _netlist.srcNetId(mosId2) && 
-        _netlist.gateNetId(mosId1) != _netlist.gateNetId(mosId2) && 
-        _netlist.drainNetId(mosId1) != _netlist.drainNetId(mosId2) && 
-        _netlist.mosType(mosId1) == MosType::DIFF && 
-        _netlist.mosType(mosId2) == MosType::DIFF)
-        return true;
-    return false;
+    return RELATION_TABLE.pattern[relation];
 }
 
-bool Pattern::validPairCascode(IndexType mosId1, IndexType mosId2) const
+/*! @brief Return pattern of a size and type matched pair. */
+static MosPattern matchedPattern(unsigned relation, bool pasvDev)
 {
-    if (_netlist.mosType(mosId1) != MosType::DIFF && 
-        _netlist.mosType(mosId1) != MosType::DIODE )
-        return false;
-    if (_netlist.mosType(mosId2) != MosType::DIFF && 
-        _netlist.mosType(mosId2) != MosType::DIODE )
-        return false;
-    if (_netlist.srcNetId(mosId1) != _netlist.srcNetId(mosId2) && 
-        _netlist.gateNetId(mosId1) == _netlist.gateNetId(mosId2) && 
-        _netlist.drainNetId(mosId1) != _netlist.drainNetId(mosId2))
-        return true;
-    return false;
+    MosPattern currPtrn = Pattern::relationPattern(relation);
+    if (currPtrn == MosPattern::INVALID && pasvDev)
+        return MosPattern::PASSIVE; // Same type passive device
+    return currPtrn;
 }
 
-bool Pattern::validPairLoad(IndexType mosId1, IndexType mosId2) const
+#ifdef PATTERN_AVX2
+/*! @brief Gather array[idx] of 8 lanes, zero extended.
+
+    Elements narrower than 4 bytes are read as the 4 bytes
+    ending at the element, or the first 4 bytes of array,
+    so nothing outside array is read. Array should be at
+    least 4 bytes.
+*/
+template <typename T>
+__attribute__((target("avx2")))
+static inline __m256i gatherLane(const T * array, __m256i idx)
 {
-    if (_netlist.mosType(mosId1) != MosType::DIFF && 
-        _netlist.mosType(mosId1) != MosType::DIODE )
-        return false;
-    if (_netlist.mosType(mosId2) != MosType::DIFF && 
-        _netlist.mosType(mosId2) != MosType::DIODE )
-        return false;
-    if (_netlist.srcNetId(mosId1) == _netlist.srcNetId(mosId2) && 
-        _netlist.gateNetId(mosId1) == _netlist.gateNetId(mosId2) && 
-        _netlist.drainNetId(mosId1) != _netlist.drainNetId(mosId2))
-        return true;
-    if (_netlist.mosType(mosId1) == MosType::DIODE &&
-        _netlist.mosType(mosId2) == MosType::DIODE &&
-        _netlist.srcNetId(mosId1) == _netlist.srcNetId(mosId2) &&
-        _netlist.drainNetId(mosId1) != _netlist.drainNetId(mosId2))
-        return true;
-    return false;
-}  
+    if constexpr (sizeof(T) == 4)
+        return _mm256_i32gather_epi32(reinterpret_cast<const int *>(array), idx, 4);
+    else
+    {
+        __m256i size = _mm256_set1_epi32(sizeof(T)), four = _mm256_set1_epi32(4);
+        __m256i begin = _mm256_mullo_epi32(idx, size);
+        __m256i addr = _mm256_sub_epi32(_mm256_max_epu32(_mm256_add_epi32(begin, size), four), four);
+        __m256i word = _mm256_i32gather_epi32(reinterpret_cast<const int *>(array), addr, 1);
+        __m256i shift = _mm256_slli_epi32(_mm256_sub_epi32(begin, addr), 3);
+        return _mm256_and_si256(_mm256_srlv_epi32(word, shift), _mm256_set1_epi32((1 << 8 * sizeof(T)) - 1));
+    }
+}
 
-bool Pattern::crossPairCascode(IndexType mosId1, IndexType mosId2) const
+/*! @brief Return 8 bit mask of lanes with array[idx] == value. */
+__attribute__((target("avx2")))
+static inline unsigned equalReal(const RealType * array, __m256i idx, RealType value)
 {
-    if (_netlist.srcNetId(mosId1) != _netlist.srcNetId(mosId2) && 
-        _netlist.gateNetId(mosId1) == _netlist.drainNetId(mosId2) && 
-        _netlist.drainNetId(mosId1) == _netlist.gateNetId(mosId2) && 
-        _netlist.mosType(mosId1) == MosType::DIFF && 
-        _netlist.mosType(mosId2) == MosType::DIFF)
-        return true;
-    return false;
+    __m256d ref = _mm256_set1_pd(value), zero = _mm256_setzero_pd();
+    __m256d all = _mm256_castsi256_pd(_mm256_set1_epi64x(-1)); // Masked gather, no undefined source
+    __m256d lo = _mm256_mask_i32gather_pd(zero, array, _mm256_castsi256_si128(idx), all, 8);
+    __m256d hi = _mm256_mask_i32gather_pd(zero, array, _mm256_extracti128_si256(idx, 1), all, 8);
+    return _mm256_movemask_pd(_mm256_cmp_pd(lo, ref, _CMP_EQ_OQ)) |
+           _mm256_movemask_pd(_mm256_cmp_pd(hi, ref, _CMP_EQ_OQ)) << 4;
 }
 
-bool Pattern::crossPairLoad(IndexType mosId1, IndexType mosId2) const
+/*! @brief Set bit in lanes where mask is set. */
+__attribute__((target("avx2")))
+static inline __m256i laneBit(__m256i mask, unsigned bit)
 {
-    if (_netlist.srcNetId(mosId1) == _netlist.srcNetId(mosId2) && 
-        _netlist.gateNetId(mosId1) == _netlist.drainNetId(mosId2) && 
-        _netlist.drainNetId(mosId1) == _netlist.gateNetId(mosId2) && 
-        _netlist.mosType(mosId1) == MosType::DIFF && 
-        _netlist.mosType(mosId2) == MosType::DIFF)
-        return true;
-    return false;
+    return _mm256_and_si256(mask, _mm256_set1_epi32(bit));
 }
 
-bool Pattern::capMos(IndexType mosId1, IndexType mosId2) const
+/*! @brief AVX2 kernel of Pattern::patterns.
+    @return Number of candidates done, a multiple of 8.
+*/
+__attribute__((target("avx2")))
+static std::size_t patternsAvx2(const Netlist::DeviceView & dev, IndexType mosId, bool pasvDev,
+                                const IndexType * candId, std::size_t numCand, MosPattern * result)
 {
-    if (_netlist.mosType(mosId1) == MosType::CAP &&
-        _netlist.mosType(mosId2) == MosType::CAP)
-        return true;
-    return false;
+    const IndexType * term = dev.termNetId + mosId * dev.numTerm;
+    __m256i src1 = _mm256_set1_epi32(term[static_cast<IndexType>(PinType::SOURCE)]);
+    __m256i gate1 = _mm256_set1_epi32(term[static_cast<IndexType>(PinType::GATE)]);
+    __m256i drain1 = _mm256_set1_epi32(term[static_cast<IndexType>(PinType::DRAIN)]);
+    __m256i type1 = _mm256_set1_epi32(static_cast<int>(dev.instType[mosId]));
+    __m256i mos1 = _mm256_set1_epi32(static_cast<int>(dev.mosType[mosId]) << MOS_TYPE1_SHIFT);
+    __m256i invalid = _mm256_set1_epi32(static_cast<int>(MosPattern::INVALID));
+    __m256i pasvPtrn = pasvDev ? _mm256_set1_epi32(static_cast<int>(MosPattern::PASSIVE)) : invalid;
+    __m256i laneMask = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+    __m256i packByte = _mm256_setr_epi8(0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                        0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+    std::size_t i = 0;
+    for (; i + 8 <= numCand; i += 8)
+    {
+        __m256i idx;
+        if constexpr (sizeof(IndexType) == 4)
+            idx = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(candId + i));
+        else
+            idx = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(candId + i)));
+        __m256i termIdx = _mm256_mullo_epi32(idx, _mm256_set1_epi32(dev.numTerm));
+        __m256i src2 = gatherLane(dev.termNetId + static_cast<IndexType>(PinType::SOURCE), termIdx);
+        __m256i gate2 = gatherLane(dev.termNetId + static_cast<IndexType>(PinType::GATE), termIdx);
+        __m256i drain2 = gatherLane(dev.termNetId + static_cast<IndexType>(PinType::DRAIN), termIdx);
+        __m256i type2 = gatherLane(dev.instType, idx);
+        __m256i mos2 = gatherLane(dev.mosType, idx);
+        unsigned match = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(type1, type2)));
+        match &= equalReal(dev.wid, idx, dev.wid[mosId]);
+        match &= equalReal(dev.len, idx, dev.len[mosId]);
+        match &= equalReal(dev.nf, idx, dev.nf[mosId]);
+        __m256i bits = _mm256_or_si256(mos1, _mm256_slli_epi32(mos2, MOS_TYPE2_SHIFT));
+        bits = _mm256_or_si256(bits, laneBit(_mm256_cmpeq_epi32(src1, src2), SRC_EQ));
+        bits = _mm256_or_si256(bits, laneBit(_mm256_cmpeq_epi32(gate1, gate2), GATE_EQ));
+        bits = _mm256_or_si256(bits, laneBit(_mm256_cmpeq_epi32(drain1, drain2), DRAIN_EQ));
+        bits = _mm256_or_si256(bits, laneBit(_mm256_cmpeq_epi32(gate1, drain2), GATE1_DRAIN2));
+        bits = _mm256_or_si256(bits, laneBit(_mm256_cmpeq_epi32(drain1, gate2), DRAIN1_GATE2));
+        __m256i ptrn = gatherLane(RELATION_TABLE.pattern, bits);
+        __m256i noPtrn = _mm256_cmpeq_epi32(ptrn, invalid);
+        ptrn = _mm256_blendv_epi8(ptrn, pasvPtrn, noPtrn); // Same type passive device if no other pattern
+        __m256i matchLane = _mm256_cmpeq_epi32(_mm256_and_si256(_mm256_set1_epi32(match), laneMask), laneMask);
+        ptrn = _mm256_blendv_epi8(invalid, ptrn, matchLane);
+// Low byte of each lane to 8 consecutive bytes
+        ptrn = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(ptrn, packByte), _mm256_setr_epi32(0, 4, 1, 1, 1, 1, 1, 1));
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(result + i), _mm256_castsi256_si128(ptrn));
+    }
+    return i;
+}
+#endif
+
+void Pattern::patterns(IndexType mosId, const IndexType * candId, std::size_t numCand,
+                       MosPattern * result) const
+{
+    std::size_t numDone = 0;
+#ifdef PATTERN_AVX2
+    static const bool hasAvx2 = __builtin_cpu_supports("avx2");
+    Netlist::DeviceView dev = _netlist.deviceView();
+// Lanes index bytes with 32-bit signed offsets, gathers need 4 bytes of array
+    if (hasAvx2 && _cache.empty() && dev.numInst >= 4 &&
+        dev.numInst * dev.numTerm * sizeof(IndexType) < INT_MAX)
+    {
+        bool pasvDev = _netlist.isPasvDev(dev.instType[mosId]);
+        numDone = patternsAvx2(dev, mosId, pasvDev, candId, numCand, result);
+    }
+#endif
+    for (std::size_t i = numDone; i < numCand; i++)
+        result[i] = pattern(mosId, candId[i]);
+}
+
+/*! @brief Initial number of cache slots. */
+static constexpr std::size_t MIN_CACHE_SLOT = 1024;
+
+/*! @brief Return cache key of unordered pair, never 0. */
+static std::uint64_t cacheKey(IndexType mosId1, IndexType mosId2)
+{
+    return (static_cast<std::uint64_t>(std::min(mosId1, mosId2)) << 32 | std::max(mosId1, mosId2)) + 1;
+}
+
+void Pattern::setCache(std::size_t maxSlot)
+{
+    _maxSlot = maxSlot == 0 ? 0 : MIN_CACHE_SLOT;
+    while (_maxSlot != 0 && 2 * _maxSlot <= maxSlot)
+        _maxSlot *= 2;
+    _cache.assign(_maxSlot == 0 ? 0 : MIN_CACHE_SLOT, CacheSlot());
+    _numCached = 0;
+}
+
+std::size_t Pattern::cacheSlot(std::uint64_t key) const
+{
+    std::size_t mask = _cache.size() - 1;
+    std::size_t pos = (key * 0x9E3779B97F4A7C15ull) >> 32 & mask; // Fibonacci hashing
+    while (_cache[pos].key != 0 && _cache[pos].key != key)
+        pos = (pos + 1) & mask; // Linear probing
+    return pos;
+}
+
+void Pattern::addCache(std::uint64_t key, std::size_t slot, MosPattern pattern) const
+{
+    if (4 * (_numCached + 1) > 3 * _cache.size())
+    {
+        std::vector<CacheSlot> oldCache(_cache.size() < _maxSlot ? 2 * _cache.size() : _cache.size());
+        oldCache.swap(_cache);
+        _numCached = 0;
+        if (_cache.size() > oldCache.size()) // Rehash if grown, else cleared 
+            for (const CacheSlot & old : oldCache)
+                if (old.key != 0)
+                    addCache(old.key, cacheSlot(old.key), old.pattern);
+        slot = cacheSlot(key);
+    }
+    _cache[slot].key = key;
+    _cache[slot].pattern = pattern;
+    _numCached++;
 }
 
 MosPattern Pattern::pattern(IndexType mosId1, IndexType mosId2) const
+{
+    if (_cache.empty())
+        return classify(mosId1, mosId2);
+    std::uint64_t key = cacheKey(mosId1, mosId2);
+    std::size_t slot = cacheSlot(key);
+    if (_cache[slot].key == key)
+    {
+        _cacheHit++;
+        return _cache[slot].pattern;
+    }
+    _cacheMiss++;
+    MosPattern currPtrn = classify(mosId1, mosId2);
+    addCache(key, slot, currPtrn);
+    return currPtrn;
+}
+
+MosPattern Pattern::classify(IndexType mosId1, IndexType mosId2) const
 {
     if (!matchedSize(mosId1, mosId2) || !matchedType(mosId1, mosId2))
-//    if (!matchedType(mosId1, mosId2))
         return MosPattern::INVALID;
-    if (crossPairCascode(mosId1, mosId2))
-        return MosPattern::CROSS_CASCODE;
-    if (crossPairLoad(mosId1, mosId2))
-        return MosPattern::CROSS_LOAD;
-    if (validPairCascode(mosId1, mosId2))
-        return MosPattern::CASCODE;
-    if (validPairLoad(mosId1, mosId2))
-        return MosPattern::LOAD;
-    if (diffPairInput(mosId1, mosId2))
-        return MosPattern::DIFF_SOURCE;
-    if (diffPairCascode(mosId1, mosId2))
-        return MosPattern::DIFF_CASCODE;
-// return true if same type passive device
-    if (capMos(mosId1, mosId2))
-        return MosPattern::PASSIVE;
-    if (_netlist.isPasvDev(_netlist.inst(mosId1).type()) &&
-        _netlist.inst(mosId1).type() == _netlist.inst(mosId2).type())
-        return MosPattern::PASSIVE;
-    return MosPattern::INVALID; 
+    return matchedPattern(relation(mosId1, mosId2), _netlist.isPasvDev(_netlist.instType(mosId1)));
 }
 
 PROJECT_NAMESPACE_END
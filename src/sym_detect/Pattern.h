@@ -11,12 +11,22 @@
 #ifndef __PATTERN_H__
 #define __PATTERN_H__
 
+#include <cstdint>
+#include <vector>
 #include "db/Netlist.h"
 #include "global/type.h"
 
 PROJECT_NAMESPACE_BEGIN
 /*! @class Pattern
     @brief Pattern class
+
+    Results of pattern() can be cached by Inst pair. All
+    patterns are symmetric in the two Ids, so the cache
+    is keyed by the unordered pair. It is an open
+    addressing hash table that doubles up to a maximum
+    number of slots, and is cleared when full at the
+    maximum. The cache is not thread safe and is off by
+    default, few pairs are classified twice in a run.
 */
 class Pattern
 {
@@ -29,8 +39,8 @@ public:
         : _netlist(netlist)
     {}
 
-/*! @brief Set netlist database. */
-    void    setNetlist(const Netlist & netlist) { _netlist = netlist; }
+/*! @brief Set netlist database. Clears the cache. */
+    void    setNetlist(const Netlist & netlist) { _netlist = netlist; setCache(_maxSlot); }
 /*! @brief Return pattern for pair of mosfets.
 
     Valid patterns have same InstType.
@@ -42,29 +52,72 @@ public:
     @param mosId2 Id for mosfet.
 */
     MosPattern          pattern(IndexType mosId1, IndexType mosId2) const;
+/*! @brief Return pattern(mosId, candId[i]) in result[i].
+
+    Batch of pattern() for one Inst against numCand
+    candidates. Candidates are evaluated 8 at a time
+    with AVX2 if the CPU has it, picked at runtime, else
+    one by one. Goes through pattern() if the cache is on.
+*/
+    void                patterns(IndexType mosId, const IndexType * candId, std::size_t numCand,
+                                MosPattern * result) const;
+/*! @brief Return relation bits of a pair of mosfets.
+
+    Bits 0-4 are set if src1 == src2, gate1 == gate2,
+    drain1 == drain2, gate1 == drain2 and drain1 == gate2,
+    bits 5-6 and 7-8 hold MosType of mosId1 and mosId2.
+    @see relationPattern
+*/
+    unsigned            relation(IndexType mosId1, IndexType mosId2) const;
+/*! @brief Return MosPattern of relation bits of a mosfet pair.
+
+    Topology part of pattern(), a constexpr table lookup
+    with the precedence of pattern(). Size and InstType 
+    are not checked, and passive devices of same InstType
+    other than MosType::CAP pairs return INVALID.
+*/
+    static MosPattern   relationPattern(unsigned relation);
+/*! @brief Cache pattern() in at most maxSlot slots.
+
+    maxSlot is rounded down to a power of 2 and is at
+    least 1024, 0 disables the cache. Cached patterns are dropped, and are only
+    valid while the netlist connectivity is unchanged.
+*/
+    void                setCache(std::size_t maxSlot);
+/*! @brief Return slots of the cache after rounding, 0 if off. */
+    std::size_t         maxSlot() const                         { return _maxSlot; }
+/*! @brief Return number of pattern() served by the cache. */
+    std::size_t         cacheHit() const                        { return _cacheHit; }
+/*! @brief Return number of pattern() classified with cache on. */
+    std::size_t         cacheMiss() const                       { return _cacheMiss; }
 
 private:
+/*! @brief Slot of the pair cache. */
+    struct CacheSlot
+    {
+        std::uint64_t   key = 0; /*!< 0 if empty. @see cacheKey */
+        MosPattern      pattern = MosPattern::INVALID;
+    };
+
     Netlist &     _netlist;
+/*! @brief Pair cache, empty if disabled. */
+    mutable std::vector<CacheSlot>  _cache;
+    std::size_t                     _maxSlot = 0;
+    mutable std::size_t             _numCached = 0;
+    mutable std::size_t             _cacheHit = 0;
+    mutable std::size_t             _cacheMiss = 0;
 
 private:
+/*! @brief Return pattern for pair of mosfets, not cached. */
+    MosPattern          classify(IndexType mosId1, IndexType mosId2) const;
+/*! @brief Return slot of key in _cache, empty if not cached. */
+    std::size_t         cacheSlot(std::uint64_t key) const;
+/*! @brief Add key to _cache at slot, growing or clearing if full. */
+    void                addCache(std::uint64_t key, std::size_t slot, MosPattern pattern) const;
 /*! @brief Return true if Inst pair have same InstType. */
     bool                matchedType(IndexType mosId1, IndexType mosId2) const;
 /*! @brief Return true if Inst pair have same size attributes. */
     bool                matchedSize(IndexType mosId1, IndexType mosId2) const;
-/*! @brief Return true if fits MosPattern::DIFF_SOURCE */
-    bool                diffPairInput(IndexType mosId1, IndexType mosId2) const;
-/*! @brief Return true if fits MosPattern::DIFF_CASCODE */
-    bool                diffPairCascode(IndexType mosId1, IndexType mosId2) const;
-/*! @brief Return true if fits MosPattern::CASCODE */
-    bool                validPairCascode(IndexType mosId1, IndexType mosId2) const;
-/*! @brief Return true if fits MosPattern::LOAD */
-    bool                validPairLoad(IndexType mosId1, IndexType mosId2) const;
-/*! @brief Return true if fits MosPattern::CROSS_CASCODE */
-    bool                crossPairCascode(IndexType mosId1, IndexType mosId2) const;
-/*! @brief Return true if fits MosPattern::CROSS_LOAD */
-    bool                crossPairLoad(IndexType mosId1, IndexType mosId2) const;
-/*! @brief Return true if Mosfets are forming matched cap. */
-    bool                capMos(IndexType mosId1, IndexType mosId2) const;
 };
 
 PROJECT_NAMESPACE_END
@@ -7,6 +7,10 @@
 #include <iostream>
 #include <fstream>
 #include <algorithm>
+#include <cmath>
+#include <memory>
+#include <tuple>
+#include "db/DisjointSet.h"
 
 PROJECT_NAMESPACE_BEGIN
 
@@ -14,7 +18,7 @@ void SymDetect::dumpSym(const std::string file) const
 {
     std::ofstream outFile(file);
     std::cout << "Dumping symmetry constraints..." << std::endl;
-    std::vector<MosPair> allPair;
+    MosPairLibrary allPair;
     for (const std::vector<MosPair> & diffPair : _symGroup) //print hiSym Groups
     {
         if (!diffPair[0].valid())
@@ -22,18 +26,18 @@ void SymDetect::dumpSym(const std::string file) const
         for (const MosPair & pair : diffPair)
         {
             if (pair.mosId1() != pair.mosId2() &&
-                !existPair(allPair, pair.mosId1()) &&
-                !existPair(allPair, pair.mosId2()))
+                !allPair.exist(pair.mosId1()) &&
+                !allPair.exist(pair.mosId2()))
             {
                 allPair.push_back(pair);
-                outFile << _netlist.inst(pair.mosId1()).name() << " " 
-                    << _netlist.inst(pair.mosId2()).name() << std::endl;
+                outFile << _netlist.instName(pair.mosId1()) << " " 
+                    << _netlist.instName(pair.mosId2()) << std::endl;
             }
             else if (pair.mosId1() == pair.mosId2() &&
-                !existPair(allPair, pair.mosId1()))
+                !allPair.exist(pair.mosId1()))
             {
                 allPair.push_back(pair);
-                outFile << _netlist.inst(pair.mosId1()).name() << std::endl; 
+                outFile << _netlist.instName(pair.mosId1()) << std::endl; 
             }
         }
         outFile << std::endl;
@@ -49,13 +53,13 @@ void SymDetect::dumpNet(const std::string file) const
     for (const NetPair & pair : _symNet)
     {
         if (pair.netId1() != pair.netId2())
-            outFile << _netlist.net(pair.netId1()).name() << " "
-                << _netlist.net(pair.netId2()).name() << std::endl;
+            outFile << _netlist.netName(pair.netId1()) << " "
+                << _netlist.netName(pair.netId2()) << std::endl;
     }
     for (const NetPair & pair : _symNet)
     {
         if (pair.netId1() == pair.netId2())
-            outFile << _netlist.net(pair.netId1()).name() << std::endl;
+            outFile << _netlist.netName(pair.netId1()) << std::endl;
     }
     std::cout << "Done..." << std::endl;
     outFile.close();
@@ -71,10 +75,10 @@ void SymDetect::print() const
         for (const MosPair & pair : diffPair)
         {
             if (pair.mosId1() != pair.mosId2()) 
-                std::cout << _netlist.inst(pair.mosId1()).name() << " " 
-                    << _netlist.inst(pair.mosId2()).name() << std::endl;
+                std::cout << _netlist.instName(pair.mosId1()) << " " 
+                    << _netlist.instName(pair.mosId2()) << std::endl;
             else
-                std::cout << _netlist.inst(pair.mosId1()).name() << std::endl; 
+                std::cout << _netlist.instName(pair.mosId1()) << std::endl; 
         }
         std::cout << "END GROUP" << std::endl;
     }
@@ -82,10 +86,10 @@ void SymDetect::print() const
     for (const NetPair & pair : _symNet)
     {
         if (pair.netId1() != pair.netId2())
-            std::cout << _netlist.net(pair.netId1()).name() << " "
-                << _netlist.net(pair.netId2()).name() << std::endl;
+            std::cout << _netlist.netName(pair.netId1()) << " "
+                << _netlist.netName(pair.netId2()) << std::endl;
         else
-            std::cout << _netlist.net(pair.netId1()).name() << std::endl;
+            std::cout << _netlist.netName(pair.netId1()) << std::endl;
     }
     std::cout << "END NET" << std::endl;
     for (const Bias & bias : _biasGroup) //print hiSym Groups
@@ -95,94 +99,160 @@ void SymDetect::print() const
         std::cout << "BEGIN BIAS" << std::endl;
         for (IndexType id : bias.bias())
         {
-            std::cout << _netlist.inst(id).name() << " "; 
+            std::cout << _netlist.instName(id) << " "; 
         }
         std::cout << std::endl << "END BIAS" << std::endl;
     }
 } 
 
-void SymDetect::getPatrnNetConn(std::vector<MosPair> & diffPair, IndexType netId,
-                                    MosPattern srchPatrn) const
+void SymDetect::merge(const SymDetect & sub, const std::vector<IndexType> & instMap,
+                      const std::vector<IndexType> & netMap)
 {
-    std::vector<IndexType> srcMos;
-    _netlist.getInstNetConn(srcMos, netId);  
-    _netlist.fltrInstNetConnPinType(srcMos, netId, PinType::SOURCE); //filter connect by source
-    _netlist.fltrInstMosType(srcMos, MosType::DIFF); //filter by MosType::DIFF
-    for (IndexType i = 0; i < srcMos.size(); i++)
+    for (const std::vector<MosPair> & group : sub._symGroup)
     {
-        for (IndexType j = i + 1; j < srcMos.size(); j++)
+        std::vector<MosPair> mapGroup;
+        for (const MosPair & pair : group)
         {
-            MosPattern pattern = _pattern.pattern(srcMos[i], srcMos[j]);
-            if (pattern == srchPatrn)
-            {
-                diffPair.emplace_back(srcMos[i], srcMos[j], pattern); //add only if matched MosPattern
-            }
+            mapGroup.emplace_back(instMap[pair.mosId1()], instMap[pair.mosId2()], pair.pattern());
+            mapGroup.back().setSrchPinType1(pair.srchPinType1());
+            mapGroup.back().setSrchPinType2(pair.srchPinType2());
+            if (!pair.valid())
+                mapGroup.back().inVld();
         }
+        for (const MosPair & pair : mapGroup)
+            _flatPair.push_back(pair);
+        _symGroup.push_back(std::move(mapGroup));
+    }
+    for (const NetPair & pair : sub._symNet)
+    {
+        IndexType netId1 = netMap[pair.netId1()], netId2 = netMap[pair.netId2()];
+        if (!_symNet.exist(netId1, netId2))
+            _symNet.emplace_back(netId1, netId2);
+    }
+    for (const Bias & bias : sub._biasGroup)
+    {
+        std::vector<IndexType> mapBias, mapDriver;
+        for (IndexType id : bias.bias())
+            mapBias.push_back(instMap[id]);
+        for (IndexType id : bias.driver())
+            mapDriver.push_back(instMap[id]);
+        _biasGroup.emplace_back(netMap[bias.netId()], _netlist, std::move(mapBias), std::move(mapDriver));
     }
 }
 
-void SymDetect::getDiffPair(std::vector<MosPair> & diffPair) const
+void SymDetect::getInstSig(std::vector<IndexType> & instSig) const
 {
-    diffPair.clear();
-    for (IndexType netId = 0; netId < _netlist.numNet(); netId++)
-        if (_netlist.isSignal(netId)) //Iterate for all signal nets for DIFF_SOURCE
-        {
-            getPatrnNetConn(diffPair, netId, MosPattern::DIFF_SOURCE); 
-            getPatrnNetConn(diffPair, netId, MosPattern::CROSS_LOAD);
-        }
-    for (IndexType netId = 0; netId < _netlist.numNet(); netId++)
-        if (!_netlist.isSignal(netId)) //Iterate for non signal nets for CROSS_LOAD
-            getPatrnNetConn(diffPair, netId, MosPattern::CROSS_LOAD); 
+    std::vector<IndexType> order(_netlist.numInst());
+    for (IndexType instId = 0; instId < _netlist.numInst(); instId++)
+        order[instId] = instId;
+    auto sizeKey = [&](IndexType instId)
+    {
+        return std::make_tuple(_netlist.instType(instId), _netlist.instWid(instId), 
+                               _netlist.instLen(instId), _netlist.instNf(instId));
+    };
+    auto hasNan = [&](IndexType instId)
+    {
+        return std::isnan(_netlist.instWid(instId)) || std::isnan(_netlist.instLen(instId)) ||
+               std::isnan(_netlist.instNf(instId));
+    };
+// NaN sizes are moved to the back, they would break the ordering
+    auto nanBegin = std::partition(order.begin(), order.end(), [&](IndexType instId) { return !hasNan(instId); });
+    std::sort(order.begin(), nanBegin, [&](IndexType a, IndexType b) { return sizeKey(a) < sizeKey(b); });
+    instSig.resize(_netlist.numInst());
+    IndexType numSig = 0;
+    for (auto it = order.begin(); it != order.end(); ++it)
+    {
+        if (it != order.begin() && (it >= nanBegin || sizeKey(*(it - 1)) != sizeKey(*it)))
+            numSig++;
+        instSig[*it] = numSig;
+    }
 }
 
-// FIXME: Currently because placement issues, existPair is broken and only output 1 pair for each instId
-bool SymDetect::existPair(const std::vector<MosPair> & library, IndexType instId1, IndexType instId2) const
+void SymDetect::getNetSig(std::vector<std::uint64_t> & netSig) const
 {
-    // return existPair(library, instId1) || existPair(library, instId2);
-    for (const MosPair & currPair : library)
+    netSig.resize(_netlist.numNet());
+    for (IndexType netId = 0; netId < _netlist.numNet(); netId++)
     {
-        if (currPair.mosId1() == instId1 && currPair.mosId2() == instId2)
-            return true;
-        if (currPair.mosId2() == instId1 && currPair.mosId1() == instId2)
-            return true;
+        IndexType numType[static_cast<Byte>(InstType::OTHER) + 1] = {0};
+        for (IndexType pinId : _netlist.netPinIdArray(netId))
+            numType[static_cast<Byte>(_netlist.instType(_netlist.pin(pinId).instId()))]++;
+        std::uint64_t sig = _netlist.netPinIdArray(netId).size();
+        for (IndexType num : numType)
+            sig = sig * 0x9E3779B97F4A7C15ull + num;
+        netSig[netId] = sig;
     }
-    return false;
 }
 
-bool SymDetect::existNetPair(std::vector<NetPair> & library, IndexType netId1, IndexType netId2) const
+void SymDetect::getPatrnNetConn(std::vector<MosPair> & diffPair, IndexType netId,
+                                    PatternMask srchMask) const
 {
-    for (const NetPair & currPair : library)
+    std::vector<IndexType> srcMos;
+    _netlist.getInstNetConn(srcMos, netId);  
+    _netlist.fltrInstNetConnPinType(srcMos, netId, PinType::SOURCE); //filter connect by source
+    _netlist.fltrInstMosType(srcMos, MosType::DIFF); //filter by MosType::DIFF
+// Bucket positions of srcMos by signature, ascending position in bucket
+    std::vector<IndexType> order(srcMos.size()), rank(srcMos.size());
+    for (IndexType i = 0; i < srcMos.size(); i++)
+        order[i] = i;
+    std::sort(order.begin(), order.end(), [&](IndexType a, IndexType b)
     {
-        if (currPair.netId1() == netId1 && currPair.netId2() == netId2)
-            return true;
-        if (currPair.netId2() == netId1 && currPair.netId1() == netId2)
-            return true;
+        return std::make_pair(_instSig[srcMos[a]], a) < std::make_pair(_instSig[srcMos[b]], b);
+    });
+// Insts in bucket order, bucket of order[r] ends before bucketEnd[r]
+    std::vector<IndexType> bucketMos(srcMos.size()), bucketEnd(srcMos.size());
+    for (IndexType r = 0; r < order.size(); r++)
+    {
+        rank[order[r]] = r;
+        bucketMos[r] = srcMos[order[r]];
     }
-    return false;
+    for (IndexType r = order.size(); r-- > 0; )
+        bucketEnd[r] = r + 1u < order.size() && _instSig[bucketMos[r]] == _instSig[bucketMos[r + 1]] ? bucketEnd[r + 1] : r + 1;
+    std::vector<MosPair> found[static_cast<Byte>(MosPattern::INVALID) + 1]; // Pairs by MosPattern
+    std::vector<MosPattern> candPtrn(srcMos.size());
+    for (IndexType i = 0; i < srcMos.size(); i++)
+    {
+// Later positions j in bucket of i, ascending as in a j > i scan
+        IndexType candBegin = rank[i] + 1, numCand = bucketEnd[rank[i]] - candBegin;
+        _pattern.patterns(srcMos[i], bucketMos.data() + candBegin, numCand, candPtrn.data());
+        for (IndexType k = 0; k < numCand; k++)
+        {
+            IndexType j = order[candBegin + k];
+            MosPattern pattern = candPtrn[k];
+            if (srchMask & patternBit(pattern))
+            {
+                found[static_cast<Byte>(pattern)].emplace_back(srcMos[i], srcMos[j], pattern); //add only if matched MosPattern
+            }
+        }
+    }
+    for (const std::vector<MosPair> & patrnPair : found)
+        diffPair.insert(diffPair.end(), patrnPair.begin(), patrnPair.end());
 }
 
-bool SymDetect::existNetPair(std::vector<NetPair> & library, IndexType netId) const
+void SymDetect::getDiffPair(MosPairLibrary & diffPair) const
 {
-    for (const NetPair & currPair : library)
+    diffPair.clear();
+    std::vector<MosPair> signalPair, supplyPair; // Non signal nets are after all signal nets
+    for (IndexType netId = 0; netId < _netlist.numNet(); netId++)
     {
-        if (currPair.netId1() == netId)
-            return true;
-        if (currPair.netId2() == netId)
-            return true;
+        if (_netlist.isSignal(netId)) //DIFF_SOURCE and CROSS_LOAD for signal nets
+            getPatrnNetConn(signalPair, netId, patternBit(MosPattern::DIFF_SOURCE) | patternBit(MosPattern::CROSS_LOAD)); 
+        else //CROSS_LOAD for non signal nets
+            getPatrnNetConn(supplyPair, netId, patternBit(MosPattern::CROSS_LOAD)); 
     }
-    return false;
+    for (const MosPair & pair : signalPair)
+        diffPair.push_back(pair);
+    for (const MosPair & pair : supplyPair)
+        diffPair.push_back(pair);
 }
 
-bool SymDetect::existPair(const std::vector<MosPair> & library, IndexType instId) const
+void SymDetect::checkSymNet()
 {
-    for (const MosPair & currPair : library)
-    {
-        if (currPair.mosId1() == instId)
-            return true;
-        if (currPair.mosId2() == instId)
-            return true;
-    }
-    return false;
+    getPartner(_flatPair, _partnerOffset, _partnerId); // Include merged pairs
+    NetPairLibrary symNet;
+    for (const NetPair & pair : _symNet)
+        if (checkNetSym(pair.netId1(), pair.netId2()))
+            symNet.push_back(pair);
+    _symNet.swap(symNet);
 }
 
 bool SymDetect::endSrch(MosPair & currObj) const
@@ -209,9 +279,8 @@ bool SymDetect::endSrch(MosPair & currObj) const
 }
 
 bool SymDetect::validSrchObj(IndexType instId1, IndexType instId2,
-                             IndexType srchPinId1, IndexType srchPinId2) const
+                             IndexType srchPinId1, IndexType srchPinId2, MosPattern currPtrn) const
 {
-    MosPattern currPtrn = _pattern.pattern(instId1, instId2);
     if (Pin::isPasvDev(_netlist.pin(srchPinId1).type()) &&
         Pin::isPasvDev(_netlist.pin(srchPinId2).type()))
         return currPtrn == MosPattern::PASSIVE; // Pass valid for all passive pairs.
@@ -235,62 +304,140 @@ bool SymDetect::validSrchObj(IndexType instId1, IndexType instId2,
 }  
 
 bool SymDetect::validDiffPair(IndexType instId1, IndexType instId2,
-                            IndexType srchPinId1, IndexType srchPinId2) const
+                            IndexType srchPinId1, IndexType srchPinId2, MosPattern currPtrn) const
 {
     if (_netlist.getPinTypeInstPinConn(instId1, srchPinId1) != PinType::GATE ||
         _netlist.getPinTypeInstPinConn(instId2, srchPinId2) != PinType::GATE)
         return false; // Should be reached through GATE.
-    if (_pattern.pattern(instId1, instId2) == MosPattern::DIFF_SOURCE)
+    if (currPtrn == MosPattern::DIFF_SOURCE)
         return true; // Should be DIFF_SOURCE pair.
     return false;
 }
 
-void SymDetect::inVldDiffPairSrch(std::vector<MosPair> & diffPairSrch, MosPair & currPair) const 
+void SymDetect::inVldDiffPairSrch(const MosPairLibrary & diffPairSrch, const MosPair & currPair, 
+                                  SrcClaim & srcClaim) const 
 {
-    for (MosPair & pair : diffPairSrch)
-        if (pair.isEqual(currPair))
-            pair.inVld();
+    std::size_t pos = diffPairSrch.find(currPair.mosId1(), currPair.mosId2());
+    if (pos == diffPairSrch.size())
+        return;
+    srcClaim.reachSrc.push_back(pos);
+    std::uint32_t claim = srcClaim.claim[pos].load(std::memory_order_relaxed);
+    while (srcClaim.srcId < claim && // Lower to the earliest reaching source
+           !srcClaim.claim[pos].compare_exchange_weak(claim, srcClaim.srcId, std::memory_order_relaxed))
+        ;
 }
 
-void SymDetect::pushNextSrchObj(std::vector<MosPair> & dfsVstPair, std::vector<MosPair> & dfsStack,
-                                MosPair & currObj, std::vector<MosPair> & diffPairSrc) const
+void SymDetect::getNextSrchObj(MosPair & currObj, const MosPairLibrary & diffPairSrc, 
+                               std::vector<MosPair> & nextObj) const
 {
-    if (endSrch(currObj))
-        return; //return if endSrch
     IndexType srchPinId1 = _netlist.instPinId(currObj.mosId1(), currObj.nextPinType1());
     IndexType srchPinId2 = _netlist.instPinId(currObj.mosId2(), currObj.nextPinType2());
     std::vector<IndexType> Mos1, Mos2;
     _netlist.getInstPinConn(Mos1, srchPinId1); //Connected Inst through nextPinType
     _netlist.getInstPinConn(Mos2, srchPinId2);
+// Mos2 by signature, ascending position in a signature
+    std::vector<IndexType> sigMos2(Mos2);
+    std::stable_sort(sigMos2.begin(), sigMos2.end(), [&](IndexType a, IndexType b) { return _instSig[a] < _instSig[b]; });
+    std::vector<MosPattern> ptrn2(Mos2.size());
     for (IndexType instId1: Mos1)
     {
-        for (IndexType instId2 : Mos2)
+        auto sigEnd = std::equal_range(sigMos2.begin(), sigMos2.end(), instId1, [&](IndexType a, IndexType b) 
+        { 
+            return _instSig[a] < _instSig[b]; 
+        });
+        IndexType candBegin = sigEnd.first - sigMos2.begin(), numCand = sigEnd.second - sigEnd.first;
+        _pattern.patterns(instId1, sigMos2.data() + candBegin, numCand, ptrn2.data()); //pattern of instId1 with same signature Mos2
+        for (IndexType k = 0; k < numCand; k++)
         {
-            if (validSrchObj(instId1, instId2, srchPinId1, srchPinId2) && // valid pattern
-                !existPair(dfsVstPair, instId1, instId2) && //not visited before
-                !existPair(dfsStack, instId1, instId2)) 
+            IndexType instId2 = sigMos2[candBegin + k];
+            if (validSrchObj(instId1, instId2, srchPinId1, srchPinId2, ptrn2[k]) || // valid pattern
+                (validDiffPair(instId1, instId2, srchPinId1, srchPinId2, ptrn2[k]) && // valid DIFF_SOURCE connected through gate.
+                 !diffPairSrc.exist(instId1, instId2))) // not already as DFS source. we don't want to merge these groups.
             {
-                MosPair currPair(instId1, instId2, _pattern.pattern(instId1, instId2));
-                currPair.setSrchPinType1(_netlist.getPinTypeInstPinConn(instId1, srchPinId1));
-                currPair.setSrchPinType2(_netlist.getPinTypeInstPinConn(instId2, srchPinId2));
-                dfsStack.push_back(currPair);
-                inVldDiffPairSrch(diffPairSrc, currPair); //invalidate DFS sources
-            }
-            else if (validDiffPair(instId1, instId2, srchPinId1, srchPinId2) && // valid DIFF_SOURCE connected through gate.
-                    !existPair(dfsVstPair, instId1, instId2) &&  // not visited
-                    !existPair(dfsStack, instId1, instId2) &&
-                    !existPair(diffPairSrc, instId1, instId2)) // not already as DFS source. we don't want to merge these groups.
-            {
-                MosPair currPair(instId1, instId2, MosPattern::DIFF_SOURCE);
-                currPair.setSrchPinType1(_netlist.getPinTypeInstPinConn(instId1, srchPinId1));
-                currPair.setSrchPinType2(_netlist.getPinTypeInstPinConn(instId2, srchPinId2));
-                dfsStack.push_back(currPair);
-                inVldDiffPairSrch(diffPairSrc, currPair);
+                nextObj.emplace_back(instId1, instId2, ptrn2[k]); // DIFF_SOURCE if through gate
+                nextObj.back().setSrchPinType1(_netlist.getPinTypeInstPinConn(instId1, srchPinId1));
+                nextObj.back().setSrchPinType2(_netlist.getPinTypeInstPinConn(instId2, srchPinId2));
             }
        }
     }
 }
 
+void SymDetect::pushNextSrchObj(MosPairLibrary & dfsVstPair, std::vector<MosPair> & dfsStack,
+                                MosPairLibrary & dfsSrchPair, const std::vector<MosPair> & nextObj, 
+                                const MosPairLibrary & diffPairSrc, SrcClaim & srcClaim) const
+{
+    for (const MosPair & currPair : nextObj)
+    {
+        if (!dfsVstPair.exist(currPair.mosId1(), currPair.mosId2()) && //not visited before
+            !dfsSrchPair.exist(currPair.mosId1(), currPair.mosId2())) 
+        {
+            dfsStack.push_back(currPair);
+            dfsSrchPair.push_back(currPair);
+            inVldDiffPairSrch(diffPairSrc, currPair, srcClaim); //invalidate DFS sources
+        }
+    }
+}
+
+/*! @brief Return true if pairs are equal and reached the same way. */
+static bool sameSrchObj(const MosPair & pair1, const MosPair & pair2)
+{
+    return pair1.mosId1() == pair2.mosId1() && pair1.mosId2() == pair2.mosId2() &&
+           pair1.pattern() == pair2.pattern() &&
+           pair1.srchPinType1() == pair2.srchPinType1() && pair1.srchPinType2() == pair2.srchPinType2();
+}
+
+void SymDetect::bfsDiffPair(MosPairLibrary & dfsVstPair, MosPair & diffPair, 
+                            const MosPairLibrary & diffPairSrc, SrcClaim & srcClaim) const
+{
+    MosPairLibrary srchObj; // Pairs with their way of reach, same Ids are chained
+    std::vector<std::uint32_t> sameIdNext; // Next in srchObj with same Ids, UINT32_MAX if last
+    std::vector<std::vector<MosPair>> nextObj; // By srchObj position
+// Return position of pair reached the same way in srchObj, append it if new
+    auto findObj = [&](const MosPair & pair)
+    {
+        std::size_t pos = srchObj.find(pair.mosId1(), pair.mosId2());
+        if (pos != srchObj.size())
+        {
+            while (!sameSrchObj(srchObj[pos], pair) && sameIdNext[pos] != UINT32_MAX)
+                pos = sameIdNext[pos];
+            if (sameSrchObj(srchObj[pos], pair))
+                return pos;
+            sameIdNext[pos] = srchObj.size();
+        }
+        srchObj.push_back(pair);
+        sameIdNext.push_back(UINT32_MAX);
+        return srchObj.size() - 1;
+    };
+// Expand every way of reach level by level, independent of search order
+    findObj(diffPair);
+    for (std::size_t levelBegin = 0, levelEnd = 1; levelBegin != levelEnd; levelEnd = srchObj.size())
+    {
+        nextObj.resize(levelEnd);
+#pragma omp parallel for schedule(dynamic) num_threads(_numThread) if(levelEnd - levelBegin > 1)
+        for (std::size_t i = levelBegin; i < levelEnd; i++)
+        {
+            if (!endSrch(srchObj[i]))
+                getNextSrchObj(srchObj[i], diffPairSrc, nextObj[i]);
+        }
+        for (std::size_t i = levelBegin; i < levelEnd; i++)
+            for (const MosPair & pair : nextObj[i])
+                findObj(pair);
+        levelBegin = levelEnd;
+    }
+// Same as dfsDiffPair with expanded pairs
+    std::vector<MosPair> dfsStack(1, diffPair);
+    MosPairLibrary dfsSrchPair;
+    dfsSrchPair.push_back(diffPair);
+    while (!dfsStack.empty())
+    {
+        MosPair currObj = dfsStack.back();
+        dfsStack.pop_back();
+        dfsVstPair.push_back(currObj);
+        pushNextSrchObj(dfsVstPair, dfsStack, dfsSrchPair, nextObj[findObj(currObj)], diffPairSrc, srcClaim);
+        addBiasSym(dfsVstPair, currObj);
+    }
+}
+
 bool SymDetect::comBias(MosPair & currObj) const
 {
     if (currObj.pattern() == MosPattern::LOAD ||
@@ -306,7 +453,7 @@ bool SymDetect::comBias(MosPair & currObj) const
     return false;
 }
 
-void SymDetect::addBiasSym(std::vector<MosPair> & dfsVstPair, MosPair & currObj) const
+void SymDetect::addBiasSym(MosPairLibrary & dfsVstPair, MosPair & currObj) const
 {
     if (comBias(currObj))
     {
@@ -314,52 +461,131 @@ void SymDetect::addBiasSym(std::vector<MosPair> & dfsVstPair, MosPair & currObj)
         _netlist.getInstNetConn(Mos, _netlist.gateNetId(currObj.mosId1()));
         _netlist.fltrInstMosType(Mos, MosType::DIODE);
         if (Mos.size() == 2 &&
-                !existPair(dfsVstPair, Mos[0], Mos[1]) && 
+                !dfsVstPair.exist(Mos[0], Mos[1]) && 
                 _pattern.pattern(Mos[0], Mos[1]) != MosPattern::INVALID)
             dfsVstPair.emplace_back(Mos[0], Mos[1], MosPattern::BIAS);
     }
 }
 
-void SymDetect::dfsDiffPair(std::vector<MosPair> & dfsVstPair, MosPair & diffPair, 
-                            std::vector<MosPair> & diffPairSrc) const
+void SymDetect::dfsDiffPair(MosPairLibrary & dfsVstPair, MosPair & diffPair, 
+                            const MosPairLibrary & diffPairSrc, SrcClaim & srcClaim) const
 {
     std::vector<MosPair> dfsStack;  //use vector to implement stack.
+    MosPairLibrary dfsSrchPair; // Popped pairs are in dfsVstPair, so visited or on stack if in either
     dfsStack.push_back(diffPair);
+    dfsSrchPair.push_back(diffPair);
     while (!dfsStack.empty()) //DFS 
     {
         MosPair currObj = dfsStack.back();
         dfsStack.pop_back();
         dfsVstPair.push_back(currObj); //pop current visit from stack and add to visited
-        pushNextSrchObj(dfsVstPair, dfsStack, currObj, diffPairSrc);
+        std::vector<MosPair> nextObj;
+        if (!endSrch(currObj)) //no next if endSrch
+            getNextSrchObj(currObj, diffPairSrc, nextObj);
+        pushNextSrchObj(dfsVstPair, dfsStack, dfsSrchPair, nextObj, diffPairSrc, srcClaim);
         addBiasSym(dfsVstPair, currObj); //Added bias symmetry pairs.
     } 
 }
 
 void SymDetect::hiSymDetect(std::vector<std::vector<MosPair>> & symGroup) const 
 {
-    std::vector<MosPair> dfsVstPair;
-    std::vector<MosPair> diffPairSrc;
+    MosPairLibrary diffPairSrc;
     getDiffPair(diffPairSrc); //get all DFS source
-    for (MosPair & pair : diffPairSrc) //for each source
+    std::uint32_t numSrc = diffPairSrc.size();
+    std::unique_ptr<std::atomic<std::uint32_t>[]> claim(new std::atomic<std::uint32_t>[numSrc]);
+    for (std::uint32_t srcId = 0; srcId < numSrc; srcId++)
+        claim[srcId].store(UINT32_MAX, std::memory_order_relaxed);
+    std::vector<std::vector<MosPair>> srcGroup(numSrc);
+    std::vector<std::vector<std::uint32_t>> reachSrc(numSrc);
+    std::vector<Byte> searched(numSrc, false);
+    auto search = [&](std::uint32_t srcId)
     {
-        if (pair.valid())
-        {
-            dfsVstPair.clear();
-            dfsDiffPair(dfsVstPair, pair, diffPairSrc); //search
-            addSelfSym(dfsVstPair); //add self symmetry pairs.
-            symGroup.push_back(dfsVstPair); //add results to new group
-        }
+        MosPairLibrary dfsVstPair;
+        SrcClaim srcClaim{srcId, claim.get(), {}};
+        MosPair pair = diffPairSrc[srcId];
+        if (_levelSrch)
+            bfsDiffPair(dfsVstPair, pair, diffPairSrc, srcClaim); //search
+        else
+            dfsDiffPair(dfsVstPair, pair, diffPairSrc, srcClaim); //search
+        addSelfSym(dfsVstPair); //add self symmetry pairs.
+        srcGroup[srcId] = dfsVstPair.pairs();
+        reachSrc[srcId].swap(srcClaim.reachSrc);
+        searched[srcId] = true;
+    };
+#pragma omp parallel for schedule(dynamic) num_threads(_numThread)
+    for (std::uint32_t srcId = 0; srcId < numSrc; srcId++) //for each source
+    {
+        if (claim[srcId].load(std::memory_order_relaxed) >= srcId) // Not reached by an earlier source yet
+            search(srcId);
     }
-    for (std::vector<MosPair> & group : symGroup)
+// Keep searches in source order, as a serial run would
+    std::vector<Byte> valid(numSrc, true);
+    std::vector<std::uint32_t> groupSrc;
+    for (std::uint32_t srcId = 0; srcId < numSrc; srcId++)
+    {
+        if (!valid[srcId])
+            continue;
+        if (!searched[srcId])
+            search(srcId); // Earlier sources reaching it are not kept
+        for (std::uint32_t reachId : reachSrc[srcId])
+            valid[reachId] = false; //invalidate DFS sources
+        symGroup.push_back(std::move(srcGroup[srcId])); //add results to new group
+        groupSrc.push_back(srcId);
+    }
+    for (std::size_t groupId = 0; groupId < groupSrc.size(); groupId++)
+    {
+        if (!valid[groupSrc[groupId]])
+            symGroup[symGroup.size() - groupSrc.size() + groupId][0].inVld();
+    }
+}
+
+void SymDetect::mergeSymGroup(std::vector<std::vector<MosPair>> & symGroup) const
+{
+    std::uint32_t numGroup = symGroup.size();
+    DisjointSet groupSet(numGroup);
+    MosPairLibrary groupPair;
+    std::vector<std::uint32_t> pairGroup; // Group of first pair in groupPair
+    for (std::uint32_t groupId = 0; groupId < numGroup; groupId++)
     {
-        for (MosPair & pair : diffPairSrc)
+        if (!symGroup[groupId][0].valid())
+            continue;
+        for (const MosPair & pair : symGroup[groupId])
         {
-            if (pair.isEqual(group[0]) && !pair.valid())
+            std::size_t pos = groupPair.find(pair.mosId1(), pair.mosId2());
+            if (pos != groupPair.size())
+                groupSet.unite(groupId, pairGroup[pos]); //shared pair
+            else
             {
-                group[0].inVld();
+                groupPair.push_back(pair);
+                pairGroup.push_back(groupId);
             }
         }
     }
+    std::vector<std::vector<MosPair>> mergeGroup;
+    std::vector<std::uint32_t> mergeId(numGroup, UINT32_MAX); // By representative
+    MosPairLibrary mergePair;
+    for (std::uint32_t groupId = 0; groupId < numGroup; groupId++)
+    {
+        if (!symGroup[groupId][0].valid())
+        {
+            mergeGroup.push_back(std::move(symGroup[groupId]));
+            continue;
+        }
+        std::uint32_t root = groupSet.find(groupId);
+        if (mergeId[root] == UINT32_MAX)
+        {
+            mergeId[root] = mergeGroup.size();
+            mergeGroup.emplace_back();
+        }
+        for (const MosPair & pair : symGroup[groupId])
+        {
+            if (mergePair.exist(pair.mosId1(), pair.mosId2()))
+                continue; // Shared pairs are in the same merged group
+            mergePair.push_back(pair);
+            mergeGroup[mergeId[root]].push_back(pair);
+        }
+    }
+    symGroup.swap(mergeGroup);
 }
 
 void SymDetect::getVldDrainMos(std::vector<IndexType> & vldMos, IndexType netId) const
@@ -370,7 +596,7 @@ void SymDetect::getVldDrainMos(std::vector<IndexType> & vldMos, IndexType netId)
 }
     
 
-void SymDetect::selfSymSrch(std::vector<MosPair> & dfsVstPair, MosPair & diffPair) const
+void SymDetect::selfSymSrch(MosPairLibrary & dfsVstPair, MosPair & diffPair) const
 {
     if (diffPair.pattern() != MosPattern::DIFF_SOURCE && diffPair.pattern() != MosPattern::CROSS_LOAD)
         return; //return if not of DIFF_SOURCE pattern.
@@ -382,7 +608,7 @@ void SymDetect::selfSymSrch(std::vector<MosPair> & dfsVstPair, MosPair & diffPai
     {
         IndexType currMosId = dfsStack.back();
         dfsStack.pop_back();
-        if (!existPair(dfsVstPair, currMosId)) //if not already as a pattern.
+        if (!dfsVstPair.exist(currMosId)) //if not already as a pattern.
             dfsVstPair.emplace_back(currMosId, currMosId, MosPattern::SELF);
         IndexType netId = _netlist.srcNetId(currMosId);
         if (_netlist.isSignal(netId)) //search if not reached ground.
@@ -395,13 +621,16 @@ void SymDetect::selfSymSrch(std::vector<MosPair> & dfsVstPair, MosPair & diffPai
     }
 }
 
-void SymDetect::addSelfSym(std::vector<MosPair> & dfsVstPair) const
+void SymDetect::addSelfSym(MosPairLibrary & dfsVstPair) const
 {
-    for (MosPair & pair : dfsVstPair)
+    for (std::size_t i = 0, numPair = dfsVstPair.size(); i < numPair; i++) // Not appended self pairs
+    {
+        MosPair pair = dfsVstPair[i];
         selfSymSrch(dfsVstPair, pair);
+    }
 }
 
-void SymDetect::flattenSymGroup(std::vector<std::vector<MosPair>> & symGroup, std::vector<MosPair> & flatPair) const
+void SymDetect::flattenSymGroup(std::vector<std::vector<MosPair>> & symGroup, MosPairLibrary & flatPair) const
 {
     for (std::vector<MosPair> & group : symGroup)
     {
@@ -412,51 +641,94 @@ void SymDetect::flattenSymGroup(std::vector<std::vector<MosPair>> & symGroup, st
     }
 }
 
+void SymDetect::getPartner(const MosPairLibrary & flatPair, std::vector<std::uint32_t> & partnerOffset,
+                           std::vector<IndexType> & partnerId) const
+{
+    partnerOffset.assign(_netlist.numInst() + 1, 0);
+    for (const MosPair & pair : flatPair)
+    {
+        partnerOffset[pair.mosId1() + 1]++;
+        if (pair.mosId1() != pair.mosId2())
+            partnerOffset[pair.mosId2() + 1]++;
+    }
+    for (IndexType instId = 0; instId < _netlist.numInst(); instId++)
+        partnerOffset[instId + 1] += partnerOffset[instId];
+    partnerId.resize(partnerOffset.back());
+    std::vector<std::uint32_t> fill(partnerOffset.begin(), partnerOffset.end() - 1);
+    for (const MosPair & pair : flatPair)
+    {
+        partnerId[fill[pair.mosId1()]++] = pair.mosId2();
+        if (pair.mosId1() != pair.mosId2())
+            partnerId[fill[pair.mosId2()]++] = pair.mosId1();
+    }
+// Sort and remove repeated partners in place
+    std::uint32_t numPartner = 0;
+    for (IndexType instId = 0; instId < _netlist.numInst(); instId++)
+    {
+        std::uint32_t begin = partnerOffset[instId];
+        std::sort(partnerId.begin() + begin, partnerId.begin() + partnerOffset[instId + 1]);
+        std::uint32_t end = std::unique(partnerId.begin() + begin, partnerId.begin() + partnerOffset[instId + 1]) - partnerId.begin();
+        partnerOffset[instId] = numPartner;
+        for (std::uint32_t p = begin; p < end; p++)
+            partnerId[numPartner++] = partnerId[p]; // numPartner <= p
+    }
+    partnerOffset.back() = numPartner;
+    partnerId.resize(numPartner);
+}
+
 bool SymDetect::checkNetSym(IndexType netId1, IndexType netId2) const
 {
-    // Very naive priliminary approach. Only check pin numbers.
-    if (_netlist.net(netId1).pinIdArray().size() != 
-        _netlist.net(netId2).pinIdArray().size())
-        return false;
-    int size = _netlist.net(netId1).pinIdArray().size();
-    bool pinSym1[size] = {false};
-    bool pinSym2[size] = {false};
-    for (int i = 0; i < size; i++)
+    IndexArray pinId1 = _netlist.netPinIdArray(netId1), pinId2 = _netlist.netPinIdArray(netId2);
+    if (pinId1.size() != pinId2.size())
+        return false; // Different pin numbers
+    if (_netSig[netId1] != _netSig[netId2])
+        return false; // Different InstType, or a hash collision
+// Pins of netId2 by Inst, ascending position for each Inst
+    std::vector<std::pair<IndexType, IndexType>> instPin2(pinId2.size());
+    for (IndexType j = 0; j < pinId2.size(); j++)
+        instPin2[j] = std::make_pair(_netlist.pin(pinId2[j]).instId(), j);
+    std::sort(instPin2.begin(), instPin2.end());
+    std::vector<IndexType> next(instPin2.size()); // First free pin of Inst, at first pin of Inst
+    for (IndexType k = 0; k < instPin2.size(); k++)
+        next[k] = k;
+    for (IndexType pinId : pinId1)
     {
-        for (int j = 0; j < size; j++)
+        IndexType instId = _netlist.pin(pinId).instId();
+        IndexType best = instPin2.size(), bestFirst = 0; // Free partner pin first on netId2
+        for (std::uint32_t p = _partnerOffset[instId]; p < _partnerOffset[instId + 1]; p++)
         {
-            if (pinSym2[j])
-                continue;
-            IndexType instId1, instId2;
-            instId1 = _netlist.pin(_netlist.net(netId1).pinIdArray().at(i)).instId();
-            instId2 = _netlist.pin(_netlist.net(netId2).pinIdArray().at(j)).instId();
-            if (existPair(_flatPair, instId1, instId2))
+            IndexType first = std::lower_bound(instPin2.begin(), instPin2.end(), 
+                                               std::make_pair(_partnerId[p], IndexType(0))) - instPin2.begin();
+            if (first == instPin2.size() || instPin2[first].first != _partnerId[p])
+                continue; // Partner not on netId2
+            IndexType k = next[first];
+            if (k < instPin2.size() && instPin2[k].first == _partnerId[p] &&
+                (best == instPin2.size() || instPin2[k].second < instPin2[best].second))
             {
-                pinSym1[i] = true;
-                pinSym2[j] = true;
-                break; //fixed bug
+                best = k;
+                bestFirst = first;
             }
         }
+        if (best == instPin2.size())
+            return false; // Pin is not symmetric
+        next[bestFirst] = best + 1;
     }
-    for (int i = 0; i < size; i++)
-        if (!pinSym1[i])
-            return false;
     return true;
 }
 
-bool SymDetect::validNetPair(IndexType netId1, IndexType netId2, std::vector<NetPair> & netPair) const
+bool SymDetect::validNetPair(IndexType netId1, IndexType netId2, NetPairLibrary & netPair) const
 {
     if (netId1 == netId2 &&
-        !existNetPair(netPair, netId1) &&
+        !netPair.exist(netId1) &&
         _netlist.isSignal(netId1))
         return checkNetSym(netId1, netId2); 
     else if (netId1 != netId2 &&
-                !existNetPair(netPair, netId1, netId2))
+                !netPair.exist(netId1, netId2))
         return checkNetSym(netId1, netId2);
     return false;
 }
 
-void SymDetect::addSymNet(std::vector<NetPair> & netPair, MosPair & currObj) const
+void SymDetect::addSymNet(NetPairLibrary & netPair, MosPair & currObj) const
 {
     if (currObj.pattern() == MosPattern::SELF)
         return;
@@ -476,7 +748,7 @@ void SymDetect::addSymNet(std::vector<NetPair> & netPair, MosPair & currObj) con
         netPair.emplace_back(netId1, netId2);
 }
 
-void SymDetect::addSelfSymNet(std::vector<NetPair> & netPair) const
+void SymDetect::addSelfSymNet(NetPairLibrary & netPair) const
 {
     for (IndexType netId = 0; netId < _netlist.numNet(); netId++)
     {
@@ -486,8 +758,8 @@ void SymDetect::addSelfSymNet(std::vector<NetPair> & netPair) const
     }
 }
 
-void SymDetect::biasGroup(std::vector<MosPair> & flatPair, std::vector<Bias> & biasGroup,
-                            std::vector<NetPair> & netPair) const
+void SymDetect::biasGroup(MosPairLibrary & flatPair, std::vector<Bias> & biasGroup,
+                            NetPairLibrary & netPair) const
 {
     std::vector<IndexType> vstNet;
     for (MosPair & pair : flatPair)
@@ -506,7 +778,7 @@ void SymDetect::biasGroup(std::vector<MosPair> & flatPair, std::vector<Bias> & b
 }
 
 void SymDetect::biasMatch(std::vector<Bias> & biasGroup, std::vector<std::vector<MosPair>> & symGroup,
-                            std::vector<MosPair> & flatPair) const
+                            MosPairLibrary & flatPair) const
 {
     for (Bias & bias : biasGroup)
     {
@@ -516,7 +788,7 @@ void SymDetect::biasMatch(std::vector<Bias> & biasGroup, std::vector<std::vector
             {
                 if (target != bias.driver().at(0) &&
                     _pattern.pattern(target, bias.driver().at(0)) != MosPattern::INVALID &&
-                    !existPair(flatPair, target))
+                    !flatPair.exist(target))
                 {
                     std::vector<MosPair> biasPair;
                     biasPair.emplace_back(bias.driver().at(0), target, MosPattern::BIAS);
@@ -9,8 +9,11 @@
 #include "db/Netlist.h"
 #include "db/MosPair.h"
 #include "db/NetPair.h"
+#include "db/PairLibrary.h"
 #include "db/Bias.h"
 #include "sym_detect/Pattern.h"
+#include <atomic>
+#include <cstdint>
 #include <vector>
 #include <string>
 
@@ -28,53 +31,153 @@ public:
  */
     explicit SymDetect() = default;
     explicit SymDetect(Netlist & netlist)
-        : _netlist(netlist), _pattern(Pattern(netlist))
+        : SymDetect(netlist, true)
+    {}
+
+/*! @brief Constructor without detection.
+
+    Used to collect results detected on sub-netlists
+    through merge(), which can then be printed and
+    dumped against netlist.
+    @param netlist Netlist class.
+    @param detect Run detection if true.
+    @param cacheSlot Maximum slots of Pattern pair cache, 0 to disable.
+    @param numThread Threads of DFS search, 1 if cache is on.
+    @param levelSrch Expand groups level by level. @see bfsDiffPair
+    @param mergeGroup Merge groups sharing pairs. @see mergeSymGroup
+*/
+    explicit SymDetect(Netlist & netlist, bool detect, std::size_t cacheSlot = 0, unsigned numThread = 1,
+                       bool levelSrch = false, bool mergeGroup = false)
+        : _netlist(netlist), _pattern(Pattern(netlist)), _numThread(cacheSlot == 0 ? numThread : 1),
+          _levelSrch(levelSrch), _mergeGroup(mergeGroup)
     {
-        hiSymDetect(_symGroup);
-        flattenSymGroup(_symGroup, _flatPair);
-        biasGroup(_flatPair, _biasGroup, _symNet);
-        biasMatch(_biasGroup, _symGroup, _flatPair);
-        addSelfSymNet(_symNet);
+        _netlist.buildConn();
+        _pattern.setCache(cacheSlot);
+        getInstSig(_instSig);
+        getNetSig(_netSig);
+        if (detect)
+        {
+            hiSymDetect(_symGroup);
+            if (_mergeGroup)
+                mergeSymGroup(_symGroup);
+            flattenSymGroup(_symGroup, _flatPair);
+            getPartner(_flatPair, _partnerOffset, _partnerId);
+            biasGroup(_flatPair, _biasGroup, _symNet);
+            biasMatch(_biasGroup, _symGroup, _flatPair);
+            addSelfSymNet(_symNet);
+        }
     }
 
+/*! @brief Constructor with the options of another SymDetect.
+
+    Detects a sub-netlist with the pattern cache, threads,
+    level search and group merging of the SymDetect its
+    results are merged into.
+    @param netlist Sub-netlist.
+    @param option SymDetect to take options from.
+*/
+    explicit SymDetect(Netlist & netlist, const SymDetect & option)
+        : SymDetect(netlist, true, option._pattern.maxSlot(), option._numThread, option._levelSrch,
+                    option._mergeGroup)
+    {}
+
 /*! @brief Set netlist database. */
     void    setNetlist(const Netlist & netlist) 
     { 
         _netlist = netlist; 
+        _netlist.buildConn();
         _pattern.setNetlist(netlist); 
+        getInstSig(_instSig);
+        getNetSig(_netSig);
         hiSymDetect(_symGroup);
+        if (_mergeGroup)
+            mergeSymGroup(_symGroup);
         flattenSymGroup(_symGroup, _flatPair);
+        getPartner(_flatPair, _partnerOffset, _partnerId);
         biasGroup(_flatPair, _biasGroup, _symNet);
         biasMatch(_biasGroup, _symGroup, _flatPair);
         addSelfSymNet(_symNet);
     }
+/*! @brief Return Pattern, for its cache counters. */
+    const Pattern &             pattern() const                     { return _pattern; }
+/*! @brief Return symmetry groups. */
+    const std::vector<std::vector<MosPair>> &   symGroup() const    { return _symGroup; }
 /*! @brief Print symGroup for netlist. */
     void                        print() const;                       
 /*! @brief Dump symmetry constraint to file. */
     void                        dumpSym(const std::string file) const;
 /*! @brief Dump symmetry net to file. */
     void                        dumpNet(const std::string file) const;
+/*! @brief Append results detected on a sub-netlist.
+
+    Ids of sub are translated with instMap and netMap into 
+    Ids of this netlist. Symmetry nets already present are
+    not added again.
+
+    @param sub SymDetect run on the sub-netlist.
+    @param instMap Inst Id of this netlist by sub Inst Id.
+    @param netMap Net Id of this netlist by sub Net Id.
+    @see SubNetlist
+*/
+    void                        merge(const SymDetect & sub, const std::vector<IndexType> & instMap,
+                                    const std::vector<IndexType> & netMap);
+/*! @brief Drop symmetry nets not symmetric in netlist.
+
+    Port nets of a sub-netlist may only look symmetric
+    locally. Call once after all merge() are done.
+*/
+    void                        checkSymNet();
+/*! @brief Add self symmetric signal nets not merged.
+
+    Nets without Inst are in no sub-netlist, but are 
+    self symmetric in flat detection. Call after 
+    checkSymNet().
+*/
+    void                        checkSelfSymNet()                   { addSelfSymNet(_symNet); }
 
 private:
+/*! @struct SrcClaim
+    @brief DFS sources reached by the search from srcId.
+
+    Reached source positions are recorded in reachSrc, 
+    and claim[pos] is lowered to srcId without locks. 
+    Concurrent searches only read DFS sources.
+    @see hiSymDetect
+*/
+    struct SrcClaim
+    {
+        std::uint32_t                   srcId;
+        std::atomic<std::uint32_t> *    claim;
+        std::vector<std::uint32_t>      reachSrc;
+    };
+
     Netlist &             _netlist;
     Pattern                     _pattern;
+/*! @brief Threads of DFS search. */
+    unsigned                    _numThread = 1;
+/*! @brief Search groups with bfsDiffPair if true. */
+    bool                        _levelSrch = false;
+/*! @brief Merge groups sharing pairs if true. */
+    bool                        _mergeGroup = false;
 /*! @brief Symmetry nets of netlist. */
-    std::vector<NetPair>        _symNet;
+    NetPairLibrary              _symNet;
 /*! @brief Symmetry groups of netlist. */
     std::vector<std::vector<MosPair>>   _symGroup;
-    std::vector<MosPair>        _flatPair;
+    MosPairLibrary              _flatPair;
     std::vector<Bias>           _biasGroup;
+/*! @brief Device signature of each Inst. @see getInstSig */
+    std::vector<IndexType>      _instSig;
+/*! @brief Signature of each Net. @see getNetSig */
+    std::vector<std::uint64_t>  _netSig;
+/*! @brief Partners of each Inst in _flatPair, in CSR form.
+    Partners of Inst i are _partnerId[_partnerOffset[i]] to 
+    _partnerId[_partnerOffset[i+1]]. @see getPartner
+*/
+    std::vector<std::uint32_t>  _partnerOffset;
+    std::vector<IndexType>      _partnerId;
 
 /*! @brief Return pattern of MosPair. */
     MosPattern                  MosPairPtrn(MosPair & obj) const;
-/*! @brief Check if pair already reached. */
-    bool                        existPair(const std::vector<MosPair> & library, IndexType instId1, IndexType instId2) const;
-/*! @breif Check if self symmetry pair already reached. */
-    bool                        existPair(const std::vector<MosPair> & library, IndexType instId) const;
-/*! @brief Check if already contains NetPair in library. */
-    bool                        existNetPair(std::vector<NetPair> & library, IndexType netId1, IndexType netId2) const;
-/*! @brief Check if self symmetry Net in library. */
-    bool                        existNetPair(std::vector<NetPair> & library, IndexType netId) const;
 
 /*! @brief Return true if end of search path. 
 
@@ -97,9 +200,10 @@ private:
     @param instId2 Reached pair instId2
     @param srchPinId1 instId1 reached by srchPinId1.
     @param srchPinId2 instId2 reached by srchPinId2.
+    @param currPtrn Pattern of instId1 and instId2.
 */
     bool                        validSrchObj(IndexType instId1, IndexType instId2, 
-                                    IndexType srchPinId1, IndexType srchPinId2) const;
+                                    IndexType srchPinId1, IndexType srchPinId2, MosPattern currPtrn) const;
 /*! @brief Return true if a valid DIFF_SOURCE gate connected.
 
     This funtion is used to expand symmetry groups through DRAIN
@@ -116,9 +220,10 @@ private:
     @param instId2 Reached pair instId2
     @param srchPinId1 instId1 reached by srchPinId1.
     @param srchPinId2 instId2 reached by srchPinId2.
+    @param currPtrn Pattern of instId1 and instId2.
 */
     bool                        validDiffPair(IndexType instId1, IndexType instId2,
-                                    IndexType srchPinId1, IndexType srchPinId2) const;
+                                    IndexType srchPinId1, IndexType srchPinId2, MosPattern currPtrn) const;
 /*! @brief Return true if a valid symmetry NetPair.
 
     A NetPair is a pair of symmetry nets.
@@ -133,28 +238,83 @@ private:
     @param netId2 Id of Net2.
     @param netPair Library for symmetry nets.
 */
-    bool                        validNetPair(IndexType netId1, IndexType netId2, std::vector<NetPair> & netPair) const;
+    bool                        validNetPair(IndexType netId1, IndexType netId2, NetPairLibrary & netPair) const;
 
-/*! @brief Check every pin of nets for symmetry. */
+/*! @brief Check every pin of nets for symmetry.
+
+    Each pin of netId1 in turn takes the first free pin of 
+    netId2 whose Inst is paired with its Inst in _flatPair.
+    Nets are symmetric if all pins of netId1 are taken.
+    Nets with different _netSig are rejected first.
+
+    Free pins of a partner Inst are taken in ascending 
+    order, so each partner keeps a cursor into its pins 
+    on netId2. This is linear in pins and partners.
+    @see getPartner
+*/
     bool                        checkNetSym(IndexType netId1, IndexType netId2) const;
+/*! @brief Get signature of every Net.
 
-/*! @brief Push next valid MosPair to dfsStack.
+    Signature hashes pin count and InstType histogram of 
+    a Net. Paired Insts have equal InstType, so nets with 
+    different signature are never symmetric. PinType is
+    left out, pairs may join different pins (cross-coupled
+    and passive pairs, self pairs across source and drain).
+
+    @param netSig Signature by Net Id.
+*/
+    void                        getNetSig(std::vector<std::uint64_t> & netSig) const;
+/*! @brief Get partners of every Inst in flatPair.
 
-    This function push valid pairs that could be reached 
-    from currObj to dfsStack. It also removes reached DIFF_SOURCE
-    MosPair from diffPairSrc. A pair is valid either a valid 
-    load or a valid second stage input DIFF_SOURCE.
+    Partners are unique and ascending, a self symmetry 
+    pair makes an Inst its own partner. Call again after
+    flatPair is appended to.
+
+    @param flatPair Symmetry pairs.
+    @param partnerOffset Offset of partners by Inst Id.
+    @param partnerId Partners in CSR form.
+*/
+    void                        getPartner(const MosPairLibrary & flatPair, std::vector<std::uint32_t> & partnerOffset,
+                                    std::vector<IndexType> & partnerId) const;
+
+/*! @brief Get valid MosPair reached from currObj.
+
+    A pair is valid either a valid load or a valid second
+    stage input DIFF_SOURCE that is not a DFS source. 
+    Visited pairs are not excluded.
+
+    Valid pairs have a pattern, so equal _instSig. Insts
+    reached by the two sides are joined on _instSig, pairs 
+    are appended in order of a full cross product.
 
-    @see inVldDiffPairSrch
     @see validSrchObj
     @see validDiffPair
+    @param currObj Current MosPair under visit
+    @param diffPairSrc All DFS sources
+    @param nextObj Valid pairs are appended
+*/
+    void                        getNextSrchObj(MosPair & currObj, const MosPairLibrary & diffPairSrc, 
+                                    std::vector<MosPair> & nextObj) const;
+/*! @brief Push next valid MosPair to dfsStack.
+
+    This function push valid pairs of nextObj, reached 
+    from the current visit, to dfsStack. It also removes reached DIFF_SOURCE
+    MosPair from diffPairSrc. 
+    A pair is not pushed twice in one search, dfsSrchPair
+    holds every pair pushed to dfsStack so far.
+
+    @see inVldDiffPairSrch
+    @see getNextSrchObj
     @param dfsVstPair All current visited MosPair
     @param dfsStack Stack to store to visit MosPair
-    @param currObj Current MosPair under visit
+    @param dfsSrchPair All MosPair pushed to dfsStack
+    @param nextObj Pairs of getNextSrchObj for current visit
     @param diffPairSrc All DFS sources
+    @param srcClaim DFS sources reached by this search
 */
-    void                        pushNextSrchObj(std::vector<MosPair> & dfsVstPair, std::vector<MosPair> & dfsStack, 
-                                    MosPair & currObj, std::vector<MosPair> & diffPairSrc) const;
+    void                        pushNextSrchObj(MosPairLibrary & dfsVstPair, std::vector<MosPair> & dfsStack, 
+                                    MosPairLibrary & dfsSrchPair, const std::vector<MosPair> & nextObj, 
+                                    const MosPairLibrary & diffPairSrc, SrcClaim & srcClaim) const;
 
 /*! @brief Return true if currObj have common gate connection.
 
@@ -166,58 +326,101 @@ private:
 */
     bool                        comBias(MosPair& currObj) const;
 /*! @brief A special case where a symmetry pair is formed in the bias group. */
-    void                        addBiasSym(std::vector<MosPair> & dfsVstPair, MosPair & currObj) const;
-/*! @brief Get srchPatrn MosPair connected to netId.
+    void                        addBiasSym(MosPairLibrary & dfsVstPair, MosPair & currObj) const;
+/*! @brief Get device signature of every Inst.
+
+    Insts have equal signature if and only if they have
+    equal InstType, width, length and nf, which is the
+    size check of Pattern::pattern. Insts with a NaN size
+    never match and get a signature of their own.
 
-    Find MosPair that follow srchPatrn. These
-    MosPair are appended to diffPair. Used to 
-    get valid DFS source. srchPatrn inputs commonly
-    are DIFF_SOURCE and CROSS_LOAD.
+    @param instSig Signature by Inst Id, dense from 0.
+*/
+    void                        getInstSig(std::vector<IndexType> & instSig) const;
+/*! @brief Get MosPair in srchMask connected to netId.
+
+    Find MosPair that follow a MosPattern in srchMask.
+    These MosPair are appended to diffPair. Used to 
+    get valid DFS source. srchMask commonly holds
+    DIFF_SOURCE and CROSS_LOAD.
     Currently pairs should follow:
-    (1) Have MosPattern srchPatrn
+    (1) Have a MosPattern in srchMask
     (2) source connected to netId
     (3) MosType::DIFF
 
+    Connected Insts are collected and each pair is
+    classified once for all patterns in srchMask. Only
+    pairs in the same _instSig bucket are classified.
+    Pairs are appended grouped by ascending MosPattern,
+    in connection order within a MosPattern. This is the
+    order of one call per MosPattern.
+
     @param netId Source should be connected to netId.
     @param diffPair Stored output vector.
+    @param srchMask MosPattern to search. @see patternBit
 */
     void                        getPatrnNetConn(std::vector<MosPair> & diffPair, IndexType netId,
-                                    MosPattern srchPatrn) const;
+                                    PatternMask srchMask) const;
 /*! @brief Get valid DFS source of netlist.
 
-    Iterate all signal nets for getPatrnNetConn.
-    Commonly srchPatrn are DIFF_SOURCE and 
-    CROSS_LOAD.
+    Iterate all nets once for getPatrnNetConn.
+    DIFF_SOURCE and CROSS_LOAD are searched on signal 
+    nets, CROSS_LOAD on non signal nets. Pairs of 
+    non signal nets are put after all signal nets.
     This would return all DFS sources.
 
     @see getDiffPairNetConn
     @param diffPair Store the output vector
 */
-    void                        getDiffPair(std::vector<MosPair> & diffPair) const;
+    void                        getDiffPair(MosPairLibrary & diffPair) const;
 /*! @brief DFS search with given source. Visited MosPair are stored.
 
     Search for symmetry patterns in DFS manner with search source as diffPair.
     Store visited valid MosPair at dfsVstPair. diffPairSrch are needed as input
-    to invalidate reached sources. dfsVstPair would be in the same hierarchy 
-    symmetry group. All symmetry nets would be appended to netPair vector.
+    to claim reached sources. dfsVstPair would be in the same hierarchy 
+    symmetry group. The search only depends on diffPair, so searches
+    from different sources may run concurrently.
 
     @see pushNextSrchObj
     @param[out] dfsVstPair Vector to store all visited MosPair
     @param[in] diffPair DFS search source
     @param[in] diffPairSrch Vector of all stored DFS search source
+    @param[out] srcClaim DFS sources reached by this search
 */
-    void                        dfsDiffPair(std::vector<MosPair> & dfsVstPair, MosPair & diffPair, 
-                                    std::vector<MosPair> & diffPairSrch) const;
-/*! @brief Invalidate visited pairs from sources.
+    void                        dfsDiffPair(MosPairLibrary & dfsVstPair, MosPair & diffPair, 
+                                    const MosPairLibrary & diffPairSrch, SrcClaim & srcClaim) const;
+/*! @brief Level by level search with given source.
+
+    getNextSrchObj only depends on the Ids, pattern and
+    PinType of a pair. Every pair reachable from diffPair,
+    once for each way it is reached, is expanded level by
+    level on _numThread threads. The DFS of dfsDiffPair
+    is then replayed on the expanded pairs, so pairs
+    reached in two ways or also bias pairs are resolved
+    as in dfsDiffPair. Only the replay is serial.
+
+    dfsVstPair and srcClaim are equal to dfsDiffPair,
+    in the same order.
+
+    @see dfsDiffPair
+    @see sameSrchObj
+*/
+    void                        bfsDiffPair(MosPairLibrary & dfsVstPair, MosPair & diffPair, 
+                                    const MosPairLibrary & diffPairSrch, SrcClaim & srcClaim) const;
+/*! @brief Claim visited pairs from sources.
 
     If a MosPair have already been visited and is 
     a DFS source, it should be invalidated
     as a DFS search source to avoid revisiting.
+    It is recorded in srcClaim, hiSymDetect then
+    invalidates it if the search is kept.
 
-    @param diffPairSrch Vector of all DFS sources.
-    @param currPair MosPair to invalidate.
+    @param diffPairSrch Library of all DFS sources, unique.
+    @param currPair MosPair to claim.
+    @param srcClaim DFS sources reached by this search.
 */
-    void                        inVldDiffPairSrch(std::vector<MosPair> & diffPairSrch, MosPair & currPair) const; 
+    void                        inVldDiffPairSrch(const MosPairLibrary & diffPairSrch, const MosPair & currPair, 
+                                    SrcClaim & srcClaim) const; 
 /*! @brief Get valid drain connected mosfet to netId.
 
     Valid Mosfets must be connected to netId through PinType::DRAIN,
@@ -239,7 +442,7 @@ private:
 
     @see getVldDrainMos
 */
-    void                        selfSymSrch(std::vector<MosPair> & dfsVstPair, MosPair & diffPair) const;
+    void                        selfSymSrch(MosPairLibrary & dfsVstPair, MosPair & diffPair) const;
 /*! @brief Top function to call to add self symmetry to already searched symmetry group.
 
     Iteratively searches for self symmetry instances for MosPattern::DIFF_SOURCE pairs in dfsVstPair.
@@ -251,7 +454,7 @@ private:
     @see selfSymSrch
     @see hiSymDetect
 */
-    void                        addSelfSym(std::vector<MosPair> & dfsVstPair) const;
+    void                        addSelfSym(MosPairLibrary & dfsVstPair) const;
 
 /*! @brief Based on currObj symmetry Inst pair, valid symmetry nets are appended to netPair.
 
@@ -262,7 +465,7 @@ private:
     @param netPair Symmetry Net appended to this vector.
     @param currObj Current symmetry Inst pair.
 */
-    void                        addSymNet(std::vector<NetPair> & netPair, MosPair & currObj) const;
+    void                        addSymNet(NetPairLibrary & netPair, MosPair & currObj) const;
 
 /*! @brief Add self Symmetry Net.
 
@@ -271,11 +474,11 @@ private:
 
     @see validNetPair
 */
-    void                        addSelfSymNet(std::vector<NetPair> & netPair) const;
+    void                        addSelfSymNet(NetPairLibrary & netPair) const;
 
 /*! @brief Flatten symmetry group hierarchy into a single vector. */
     void                        flattenSymGroup(std::vector<std::vector<MosPair>> & symGroup,
-                                    std::vector<MosPair> & flatPair) const;
+                                    MosPairLibrary & flatPair) const;
 
 /*! @brief Find all bias groups.
 
@@ -290,8 +493,8 @@ private:
     @param biasGroup Saved bias groups to vector.
     @param netPair Saved symmetry nets.
 */
-    void                        biasGroup(std::vector<MosPair> & flatPair, 
-                                    std::vector<Bias> & biasGroup, std::vector<NetPair> & netPair) const;
+    void                        biasGroup(MosPairLibrary & flatPair, 
+                                    std::vector<Bias> & biasGroup, NetPairLibrary & netPair) const;
 
 /*! @brief Search for symmetry pairs in each group.
 
@@ -302,7 +505,7 @@ private:
     @param flatPair Used to check for redundancy.
 */
     void                        biasMatch(std::vector<Bias> & biasGroup, 
-                                    std::vector<std::vector<MosPair>> & symGroup, std::vector<MosPair> & flatPair) const;
+                                    std::vector<std::vector<MosPair>> & symGroup, MosPairLibrary & flatPair) const;
 
 /*! @brief Hierarchy symmetry detection. 
     
@@ -313,11 +516,32 @@ private:
     it should be of self symmetry. This funtion has been 
     also updated to contain basic passive pair symmetry. 
 
+    Sources are searched on _numThread threads. A source
+    reached by a search from an earlier source is not
+    searched ahead. Searches are then kept in source order
+    as in a serial run: a search is kept if no kept earlier
+    search reached its source, and is run there if it was
+    not run ahead. So symGroup does not depend on threads.
+
     @param symGroup Detected symmetry groups of netlist.
     @see MosPattern
     @see MosPair
 */
     void                        hiSymDetect(std::vector<std::vector<MosPair>> & symGroup) const;
+
+/*! @brief Merge valid symmetry groups that share a pair.
+
+    Searches from different sources may reach the same
+    pair without reaching each other's source, so the
+    pair would be reported in both groups. Groups are
+    joined through their shared pairs in a DisjointSet,
+    each merged group takes the place of its first group
+    and lists each pair once. Groups with invalid heads
+    are kept as is.
+
+    @param symGroup Symmetry groups from hiSymDetect.
+*/
+    void                        mergeSymGroup(std::vector<std::vector<MosPair>> & symGroup) const;
 };
 
 PROJECT_NAMESPACE_END